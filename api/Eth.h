@@ -42,6 +42,34 @@
 #define TRANSMIT_FRAME_CHECK_SEQUENCE_ERROR     (0x0C)
 #define CONTROL_DATA_PROTECTION_ERROR           (0x0D)
 
+/* Eth_MainFunction work accounting */
+typedef struct {
+	uint32 Calls;
+	uint32 Overruns;        /* calls that ran out of frame or time budget */
+	uint16 LastFrames;      /* frames handled in the last call */
+	uint16 MaxFrames;
+	uint32 LastTimeUs;      /* time spent in the last call */
+	uint32 MaxTimeUs;
+} Eth_MainFunctionStatsType;
+
+
+/* Upper layer callbacks, same as EthIf_RxIndication / EthIf_TxConfirmation.
+** A Tx confirmation means the frame was handed over to the MACPHY, not that it
+** went out on the wire. The Tx failures show in Eth_GetTxErrorCounterValues. */
+typedef void (*Eth_RxIndicationFnType)(uint8 CtrlIdx, Eth_FrameType FrameType, boolean IsBroadcast,
+	const uint8* PhysAddrPtr, const Eth_DataType* DataPtr, uint16 LenByte);
+typedef void (*Eth_TxConfirmationFnType)(uint8 CtrlIdx, Eth_BufIdxType BufIdx, Std_ReturnType Result);
+
+
+/* One fragment of the payload given to Eth_TransmitFrags */
+typedef struct {
+	const uint8* DataPtr;
+	uint16 LenByte;
+} Eth_FragType;
+
+#define ETH_MAX_TX_FRAGS	(7) /* + 1 for the header, filled by the driver */
+
+
 typedef struct {
 	uint32 SpiStatusRegister;
 	boolean Sync; /*  TRUE: MACPHY is not configured. FALSE: MACPHY is configured */
@@ -51,15 +79,35 @@ typedef struct {
 
 
 void Eth_Init(const Eth_ConfigType* CfgPtr);
+void Eth_SetUpperLayerCbk(Eth_RxIndicationFnType RxIndication, Eth_TxConfirmationFnType TxConfirmation);
+void Eth_MainFunction(void);
+Std_ReturnType Eth_GetMainFunctionStats(uint8 CtrlIdx, Eth_MainFunctionStatsType* StatsPtr);
 
 
 BufReq_ReturnType Eth_ProvideTxBuffer(uint8 CtrlIdx, uint8 Priority, Eth_BufIdxType* BufIdxPtr,
 	uint8** BufPtr, uint16* LenBytePtr);
+BufReq_ReturnType Eth_ProvideTxBufferVlan(uint8 CtrlIdx, uint8 Priority, uint16 VlanId,
+	Eth_BufIdxType* BufIdxPtr, uint8** BufPtr, uint16* LenBytePtr);
 
 Std_ReturnType Eth_Transmit(uint8 CtrlIdx, Eth_BufIdxType BufIdx, Eth_FrameType FrameType,
 	boolean TxConfirmation, uint16 LenByte, const uint8* PhysAddrPtr);
 
+Std_ReturnType Eth_TransmitFrags(uint8 CtrlIdx, Eth_FrameType FrameType, boolean TxConfirmation,
+	const Eth_FragType* FragPtr, uint8 NumFrags, const uint8* PhysAddrPtr, Eth_BufIdxType* BufIdxPtr);
+
 void Eth_TxConfirmation(uint8 CtrlIdx);
 void Eth_Receive(uint8 CtrlIdx, uint8 FifoIdx, Eth_RxStatusType* RxStatusPtr);
+uint16 Eth_RxPipeDeliver(uint8 CtrlIdx, uint16 Budget);
+Std_ReturnType Eth_GetSpiStatus(uint8 CtrlIdx, Eth_SpiStatusType* SpiStatusPtr);
+Std_ReturnType Eth_SetRxVlanStrip(uint8 CtrlIdx, boolean Enable);
+Std_ReturnType Eth_GetRxVlanTag(uint8 CtrlIdx, uint16* TciPtr);
+Std_ReturnType Eth_GetCurrentTime(uint8 CtrlIdx, Eth_TimeStampQualType* timeQualPtr,
+	Eth_TimeStampType* timeStampPtr);
+Std_ReturnType Eth_GetIngressTimeStamp(uint8 CtrlIdx, const Eth_DataType* DataPtr,
+	Eth_TimeStampQualType* timeQualPtr, Eth_TimeStampType* timeStampPtr);
+Std_ReturnType Eth_GetEgressTimeStamp(uint8 CtrlIdx, Eth_BufIdxType BufIdx,
+	Eth_TimeStampQualType* timeQualPtr, Eth_TimeStampType* timeStampPtr);
+
+Std_ReturnType Eth_GetTxErrorCounterValues(uint8 CtrlIdx, Eth_TxErrorCounterValuesType* TxErrorCounterValues);
 
 #endif
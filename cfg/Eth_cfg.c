@@ -12,6 +12,8 @@ const Eth_ConfigType EthConfigs[ETH_DRIVER_MAX_CHANNEL] = {
 		.general = {
 			.index = 0,
 			.mainfn_period_ms = 100,
+			.mainfn_bdgt_frm = 16,
+			.mainfn_bdgt_us = 2000,
 			.dev_error_detect = FALSE,
 			.get_cntr_val_api = FALSE,
 			.get_rx_stats_api = FALSE,
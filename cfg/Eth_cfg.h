@@ -11,6 +11,8 @@
 
 typedef struct {
     uint16  mainfn_period_ms;
+    uint16  mainfn_bdgt_frm; /* max. frames handled per Eth_MainFunction call */
+    uint16  mainfn_bdgt_us;  /* max. time spent per Eth_MainFunction call */
     uint8   index;
     boolean dev_error_detect;
     boolean get_cntr_val_api;
@@ -59,6 +61,8 @@ typedef enum {
 typedef enum {
 	ETH_DEV_NONE,
 	ETH_DEV_ENC28J60,
+	ETH_DEV_ENC424J600,
+	ETH_DEV_TC6, /* OPEN Alliance 10BASE-T1S MACPHY */
 	MAX_ETH_DEV
 } EthControllerDevType;
 
@@ -21,20 +21,63 @@
 #include <Eth.h>
 
 #include <macphy.h>
+#include <macphy_mpool.h>
+#include <macphy_rxpipe.h>
+#include <macphy_trace.h>
+#include <os_api.h>
+
+#include <string.h>
 
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(Eth, LOG_LEVEL_DBG);
 
 
+#define ETH_MAX_FRAME_LEN	(1522)
+#define ETH_HEADER_LEN		(14)
+#define ETH_VLAN_TAG_LEN	(4)
+#define ETH_MAX_PAYLOAD_LEN	(1500)
+#define ETH_VLAN_TPID		(0x8100)
+#define ETH_TX_PAYLOAD_OFS	(MEM_POOL_TX_DATA_OFS + ETH_HEADER_LEN)
+#define ETH_TS_VALID_ERR_NS	(20000) /* software timestamps with a wider window are ETH_UNCERTAIN */
+
+
+static const Eth_ConfigType* EthCfgPtr;
+static Eth_RxIndicationFnType EthRxIndication;
+static Eth_TxConfirmationFnType EthTxConfirmation;
+
+static const uint8 EthBcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static uint8 EthRxBuf[ETH_MAX_FRAME_LEN];
+
+static Eth_MainFunctionStatsType EthMainStats[ETH_DRIVER_MAX_CHANNEL];
+static boolean EthRxBacklog[ETH_DRIVER_MAX_CHANNEL]; /* last call ran out of budget */
+static boolean EthInitDone;
+
+static boolean EthRxVlanStrip[ETH_DRIVER_MAX_CHANNEL];
+static uint16 EthRxVlanTci;     /* tag of the frame being indicated */
+static boolean EthRxVlanValid;
+
+static macphy_ts_t EthRxTs;             /* timestamp of the frame being indicated */
+static const Eth_DataType* EthRxDataPtr;
+static macphy_ts_t EthTxTs;             /* timestamp of the frame being confirmed */
+static uint32 EthTxTsIdx;
+static boolean EthTxTsActive;
+
+#if MACPHY_RX_PIPE_ENABLE == 1
+static uint8 EthRxPipeCtrl;             /* controller of the frames being delivered */
+#endif
+
+
 void Eth_Init(const Eth_ConfigType* CfgPtr) {
 	uint16 i, o;
-	char mac[16];
+	char mac[18]; /* XX:XX:XX:XX:XX:XX */
+
+	EthCfgPtr = CfgPtr;
 
 	for (i = 0; i < ETH_DRIVER_MAX_CHANNEL; i++) {
 		if (CfgPtr[i].ctrlcfg.enable_mii == TRUE) {
 			// call function to initialize the MACPHY via SPI
-			macphy_init(CfgPtr[i].ctrlcfg.mac_addres);
+			macphy_init(&CfgPtr[i]);
 		}
 	}
 
@@ -42,36 +85,514 @@ void Eth_Init(const Eth_ConfigType* CfgPtr) {
 	for (i = 1, o = 2; i < 6; i++, o += 3) {
 		sprintf(mac+o, ":%02X", CfgPtr[0].ctrlcfg.mac_addres[i]);
 	}
-	mac[o+3] = "\0";
 	LOG_INF("Eth0 MAC: %s", mac);
+#if MACPHY_RX_PIPE_ENABLE == 1
+	macphy_rxpipe_init();
+#endif
+	EthInitDone = TRUE;
 	LOG_DBG("Init complete!");
 }
 
 
 
+// Registers the upper layer (EthIf) indication functions
+void Eth_SetUpperLayerCbk(Eth_RxIndicationFnType RxIndication, Eth_TxConfirmationFnType TxConfirmation) {
+	EthRxIndication = RxIndication;
+	EthTxConfirmation = TxConfirmation;
+}
+
+
+
+// A VLAN buffer leaves room for the tag in front of the payload, so that the
+// tag is written along with the header in Eth_Transmit and nothing is moved
+static BufReq_ReturnType Eth_ProvideTxBufferInt(uint8 CtrlIdx, uint8 Priority, boolean Vlan,
+	Eth_BufIdxType* BufIdxPtr, uint8** BufPtr, uint16* LenBytePtr) {
+	spi_mpool_t *mpool;
+	uint16 ofs = ETH_TX_PAYLOAD_OFS + ((Vlan) ? ETH_VLAN_TAG_LEN : 0);
+
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) ||
+		(BufIdxPtr == NULL) || (BufPtr == NULL) || (LenBytePtr == NULL)) {
+		return BUFREQ_E_NOT_OK;
+	}
+
+	if (*LenBytePtr > MEM_POOL_BUF_LEN - ofs) {
+		*LenBytePtr = MEM_POOL_BUF_LEN - ofs;
+		return BUFREQ_E_OVFL;
+	}
+
+	/* no Tx credit left, the upper layer shall retry later */
+	mpool = get_new_spi_mpool_tx();
+	if (mpool == NULL) {
+		return BUFREQ_E_BUSY;
+	}
+	mpool->tx_confirm = FALSE;
+	mpool->vlan = Vlan;
+	mpool->prio = Priority & 0x07;
+
+	*BufIdxPtr = (Eth_BufIdxType) get_spi_mpool_idx(mpool);
+	*BufPtr = mpool->tx_buf + ofs;
+	MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+
+	return BUFREQ_OK;
+}
+
+
 // Provides access to a transmit buffer of the specified Ethernet controller
 BufReq_ReturnType Eth_ProvideTxBuffer(uint8 CtrlIdx, uint8 Priority, Eth_BufIdxType* BufIdxPtr,
 	uint8** BufPtr, uint16* LenBytePtr) {
+	return Eth_ProvideTxBufferInt(CtrlIdx, Priority, FALSE, BufIdxPtr, BufPtr, LenBytePtr);
+}
+
 
-	return BUFREQ_E_NOT_OK;
+// Same as Eth_ProvideTxBuffer, the frame is sent with an 802.1Q tag of VlanId
+// and Priority as PCP. Priority also orders the Tx FIFO.
+BufReq_ReturnType Eth_ProvideTxBufferVlan(uint8 CtrlIdx, uint8 Priority, uint16 VlanId,
+	Eth_BufIdxType* BufIdxPtr, uint8** BufPtr, uint16* LenBytePtr) {
+	BufReq_ReturnType ret;
+	spi_mpool_t *mpool;
+	uint8 *tag;
+
+	ret = Eth_ProvideTxBufferInt(CtrlIdx, Priority, TRUE, BufIdxPtr, BufPtr, LenBytePtr);
+	if (ret == BUFREQ_OK) {
+		mpool = get_spi_mpool_by_idx(*BufIdxPtr);
+		tag = mpool->tx_buf + MEM_POOL_TX_DATA_OFS + 12;
+		tag[0] = (uint8)(ETH_VLAN_TPID >> 8);
+		tag[1] = (uint8)(ETH_VLAN_TPID & 0xFF);
+		tag[2] = (uint8)(((Priority & 0x07) << 5) | ((VlanId >> 8) & 0x0F));
+		tag[3] = (uint8)(VlanId & 0xFF);
+	}
+
+	return ret;
 }
 
 
 // Triggers frame transmission confirmation
 void Eth_TxConfirmation(uint8 CtrlIdx) {
+	uint32 idx;
+
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL)) {
+		return;
+	}
+
+	/* frames are confirmed once they are handed over to the MAC, with E_OK.
+	A later abort or collision is only counted in the Tx error counters */
+	while (get_spi_mpool_tx_done(&idx, &EthTxTs)) {
+		if (EthTxConfirmation != NULL) {
+			EthTxTsIdx = idx;
+			EthTxTsActive = TRUE;
+			EthTxConfirmation(CtrlIdx, (Eth_BufIdxType) idx, E_OK);
+			EthTxTsActive = FALSE;
+		}
+	}
+}
+
+
+// Strips the VLAN tag if enabled and indicates a received frame to the upper
+// layer. Returns TRUE if the frame was long enough to be indicated.
+static boolean Eth_RxIndicate(uint8 CtrlIdx, uint8* frame, uint16 len) {
+	Eth_FrameType frame_type;
+	boolean is_bcast, done = FALSE;
+
+	EthRxVlanValid = FALSE;
+
+	/* strip the tag: only the MAC addresses move up over it, the tag is
+	kept for Eth_GetRxVlanTag */
+	if (EthRxVlanStrip[CtrlIdx] && (len >= ETH_HEADER_LEN + ETH_VLAN_TAG_LEN) &&
+		(((frame[12] << 8) | frame[13]) == ETH_VLAN_TPID)) {
+		EthRxVlanTci = (frame[14] << 8) | frame[15];
+		EthRxVlanValid = TRUE;
+		memmove(frame + ETH_VLAN_TAG_LEN, frame, 12);
+		frame += ETH_VLAN_TAG_LEN;
+		len -= ETH_VLAN_TAG_LEN;
+	}
+
+	if (len >= ETH_HEADER_LEN) {
+		frame_type = (frame[12] << 8) | frame[13];
+		is_bcast = (memcmp(frame, EthBcastAddr, sizeof(EthBcastAddr)) == 0) ? TRUE : FALSE;
+		if (EthRxIndication != NULL) {
+			EthRxDataPtr = &frame[ETH_HEADER_LEN];
+			EthRxIndication(CtrlIdx, frame_type, is_bcast, &frame[6],
+				&frame[ETH_HEADER_LEN], len - ETH_HEADER_LEN);
+		}
+		done = TRUE;
+	}
+	EthRxVlanValid = FALSE;
+	EthRxDataPtr = NULL;
 
+	return done;
 }
 
 
 // Receive a frame from the related fifo
 void Eth_Receive(uint8 CtrlIdx, uint8 FifoIdx, Eth_RxStatusType* RxStatusPtr) {
+	uint16 len;
+
+	(void) FifoIdx; /* the MACPHYs have a single Rx FIFO */
+	if (RxStatusPtr == NULL) {
+		return;
+	}
+	*RxStatusPtr = ETH_NOT_RECEIVED;
+
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL)) {
+		return;
+	}
+
+	len = macphy_pkt_recv(EthRxBuf, sizeof(EthRxBuf));
+	if ((len == 0) || (macphy_get_rx_ts(&EthRxTs) == FALSE)) {
+		EthRxTs.valid = FALSE;
+	}
+
+	if (Eth_RxIndicate(CtrlIdx, EthRxBuf, len)) {
+		*RxStatusPtr = ETH_RECEIVED;
+	}
+
+	if (macphy_rx_pending()) {
+		*RxStatusPtr = ETH_RECEIVED_MORE_DATA_AVAILABLE;
+	}
+}
+
 
+#if MACPHY_RX_PIPE_ENABLE == 1
+static void Eth_RxPipeIndicate(uint8* frame, uint16 len) {
+	Eth_RxIndicate(EthRxPipeCtrl, frame, len);
+}
+#endif
+
+
+// Delivery stage of the Rx pipe, to be called from a thread on the other core
+// while Eth_MainFunction reads the frames into the pipe. Indicates up to
+// Budget frames and returns their number, 0 without MACPHY_RX_PIPE_ENABLE.
+uint16 Eth_RxPipeDeliver(uint8 CtrlIdx, uint16 Budget) {
+#if MACPHY_RX_PIPE_ENABLE == 1
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL)) {
+		return 0;
+	}
+
+	/* the frames were read in another context, they have no timestamp */
+	EthRxPipeCtrl = CtrlIdx;
+	EthRxTs.valid = FALSE;
+	return macphy_rxpipe_deliver(Budget, Eth_RxPipeIndicate);
+#else
+	(void) CtrlIdx;
+	(void) Budget;
+	return 0;
+#endif
 }
 
 
 Std_ReturnType Eth_Transmit(uint8 CtrlIdx, Eth_BufIdxType BufIdx, Eth_FrameType FrameType,
 	boolean TxConfirmation, uint16 LenByte, const uint8* PhysAddrPtr) {
+	spi_mpool_t *mpool;
+	uint8 *hdr;
+	uint16 hdr_len;
+
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL)) {
+		return E_NOT_OK;
+	}
+
+	mpool = get_spi_mpool_by_idx(BufIdx);
+	if ((mpool == NULL) || (mpool->state != MPOOL_ACQUIRED)) {
+		return E_NOT_OK;
+	}
+
+	/* a zero length releases the buffer without transmission */
+	hdr_len = ETH_HEADER_LEN + ((mpool->vlan) ? ETH_VLAN_TAG_LEN : 0);
+	if ((LenByte == 0) || (PhysAddrPtr == NULL) ||
+		(LenByte > MEM_POOL_BUF_LEN - MEM_POOL_TX_DATA_OFS - hdr_len)) {
+		free_spi_mpool(mpool);
+		return (LenByte == 0) ? E_OK : E_NOT_OK;
+	}
+
+	/* the VLAN tag (if any) is in place already, from Eth_ProvideTxBufferVlan */
+	hdr = mpool->tx_buf + MEM_POOL_TX_DATA_OFS;
+	memcpy(hdr, PhysAddrPtr, 6);
+	memcpy(hdr+6, EthCfgPtr[CtrlIdx].ctrlcfg.mac_addres, 6);
+	hdr[hdr_len-2] = (uint8)(FrameType >> 8);
+	hdr[hdr_len-1] = (uint8)(FrameType & 0xFF);
+
+	mpool->dlen = hdr_len + LenByte;
+	mpool->tx_confirm = TxConfirmation;
+
+	return (macphy_mpool_send(mpool) == TRUE) ? E_OK : E_NOT_OK;
+}
+
+
+
+// Sends a frame whose payload is spread over NumFrags buffers, the header is
+// filled in as in Eth_Transmit. The fragments are streamed into the MACPHY
+// without assembling them first, where the MACPHY supports it. To be called
+// from the Eth_MainFunction context. With TxConfirmation the frame is copied
+// into a Tx buffer, whose index is returned in BufIdxPtr and confirmed to the
+// upper layer as for Eth_Transmit.
+Std_ReturnType Eth_TransmitFrags(uint8 CtrlIdx, Eth_FrameType FrameType, boolean TxConfirmation,
+	const Eth_FragType* FragPtr, uint8 NumFrags, const uint8* PhysAddrPtr, Eth_BufIdxType* BufIdxPtr) {
+	macphy_frag_t frags[ETH_MAX_TX_FRAGS + 1];
+	uint8 hdr[ETH_HEADER_LEN];
+	uint16 len = 0;
+	uint32 idx;
+	uint8 i;
+
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) || (FragPtr == NULL) ||
+		(NumFrags == 0) || (NumFrags > ETH_MAX_TX_FRAGS) || (PhysAddrPtr == NULL) ||
+		(TxConfirmation && (BufIdxPtr == NULL))) {
+		return E_NOT_OK;
+	}
+
+	memcpy(hdr, PhysAddrPtr, 6);
+	memcpy(hdr+6, EthCfgPtr[CtrlIdx].ctrlcfg.mac_addres, 6);
+	hdr[12] = (uint8)(FrameType >> 8);
+	hdr[13] = (uint8)(FrameType & 0xFF);
+	frags[0].data = hdr;
+	frags[0].len = ETH_HEADER_LEN;
+
+	for (i = 0; i < NumFrags; i++) {
+		frags[i+1].data = FragPtr[i].DataPtr;
+		frags[i+1].len = FragPtr[i].LenByte;
+		len += FragPtr[i].LenByte;
+	}
+
+	/* the MAC pads the short frames */
+	if ((len == 0) || (len > ETH_MAX_PAYLOAD_LEN)) {
+		return E_NOT_OK;
+	}
+
+	if (FALSE == macphy_frags_send(frags, NumFrags + 1, TxConfirmation, &idx)) {
+		return E_NOT_OK;
+	}
+	/* a frame without confirmation may have been streamed, it has no buffer */
+	if (TxConfirmation) {
+		*BufIdxPtr = (Eth_BufIdxType) idx;
+	}
+
+	return E_OK;
+}
+
+
+// Enables the removal of the 802.1Q tag from the received frames
+Std_ReturnType Eth_SetRxVlanStrip(uint8 CtrlIdx, boolean Enable) {
+	if (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) {
+		return E_NOT_OK;
+	}
+	EthRxVlanStrip[CtrlIdx] = Enable;
+
+	return E_OK;
+}
+
+
+// Tag (TCI) that was stripped from the frame being indicated, to be called
+// from the Rx indication. E_NOT_OK if the frame had no tag.
+Std_ReturnType Eth_GetRxVlanTag(uint8 CtrlIdx, uint16* TciPtr) {
+	if ((CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) || (TciPtr == NULL) || (EthRxVlanValid == FALSE)) {
+		return E_NOT_OK;
+	}
+	*TciPtr = EthRxVlanTci;
+
+	return E_OK;
+}
+
+
+
+// Converts a software timestamp, the quality tells if the capture window is
+// within ETH_TS_VALID_ERR_NS
+static Std_ReturnType Eth_ConvertTimeStamp(const macphy_ts_t* ts, Eth_TimeStampQualType* timeQualPtr,
+	Eth_TimeStampType* timeStampPtr) {
+	uint64 ns, sec;
+	uint32 err_ns;
+
+	if (macphy_ts_to_ns(ts, &ns, &err_ns) == FALSE) {
+		*timeQualPtr = ETH_INVALID;
+		return E_NOT_OK;
+	}
+
+	sec = ns / 1000000000u;
+	timeStampPtr->nanoseconds = (uint32)(ns % 1000000000u);
+	timeStampPtr->seconds = (uint32) sec;
+	timeStampPtr->secondsHi = (uint16)(sec >> 32);
+	*timeQualPtr = (err_ns <= ETH_TS_VALID_ERR_NS) ? ETH_VALID : ETH_UNCERTAIN;
+
+	return E_OK;
+}
+
+
+static boolean Eth_TimeApiOk(uint8 CtrlIdx, Eth_TimeStampQualType* timeQualPtr,
+	Eth_TimeStampType* timeStampPtr) {
+	return ((EthCfgPtr != NULL) && (CtrlIdx < ETH_DRIVER_MAX_CHANNEL) &&
+		(timeQualPtr != NULL) && (timeStampPtr != NULL) &&
+		(EthCfgPtr[CtrlIdx].general.get_gbl_time_api == TRUE)) ? TRUE : FALSE;
+}
+
+
+// Current time on the time base of the frame timestamps (time since boot)
+Std_ReturnType Eth_GetCurrentTime(uint8 CtrlIdx, Eth_TimeStampQualType* timeQualPtr,
+	Eth_TimeStampType* timeStampPtr) {
+	macphy_ts_t now;
+
+	if (Eth_TimeApiOk(CtrlIdx, timeQualPtr, timeStampPtr) == FALSE) {
+		return E_NOT_OK;
+	}
+	macphy_ts_capture(&now, k_cycle_get_32(), 0);
+
+	return Eth_ConvertTimeStamp(&now, timeQualPtr, timeStampPtr);
+}
+
+
+// Ingress timestamp of the frame being indicated, to be called from the Rx
+// indication with its DataPtr
+Std_ReturnType Eth_GetIngressTimeStamp(uint8 CtrlIdx, const Eth_DataType* DataPtr,
+	Eth_TimeStampQualType* timeQualPtr, Eth_TimeStampType* timeStampPtr) {
+	if (Eth_TimeApiOk(CtrlIdx, timeQualPtr, timeStampPtr) == FALSE) {
+		return E_NOT_OK;
+	}
+	if ((DataPtr == NULL) || (DataPtr != EthRxDataPtr)) {
+		*timeQualPtr = ETH_INVALID;
+		return E_NOT_OK;
+	}
+
+	return Eth_ConvertTimeStamp(&EthRxTs, timeQualPtr, timeStampPtr);
+}
+
+
+// Egress timestamp of the frame being confirmed, to be called from the Tx
+// confirmation with its BufIdx
+Std_ReturnType Eth_GetEgressTimeStamp(uint8 CtrlIdx, Eth_BufIdxType BufIdx,
+	Eth_TimeStampQualType* timeQualPtr, Eth_TimeStampType* timeStampPtr) {
+	if (Eth_TimeApiOk(CtrlIdx, timeQualPtr, timeStampPtr) == FALSE) {
+		return E_NOT_OK;
+	}
+	if ((EthTxTsActive == FALSE) || (BufIdx != EthTxTsIdx)) {
+		*timeQualPtr = ETH_INVALID;
+		return E_NOT_OK;
+	}
+
+	return Eth_ConvertTimeStamp(&EthTxTs, timeQualPtr, timeStampPtr);
+}
+
+
+
+// Reads the SPI status of the MACPHY, the credits tell how many frames can be
+// given to Eth_Transmit and how many are waiting in the MACPHY to be received
+Std_ReturnType Eth_GetSpiStatus(uint8 CtrlIdx, Eth_SpiStatusType* SpiStatusPtr) {
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) || (SpiStatusPtr == NULL)) {
+		return E_NOT_OK;
+	}
+
+	SpiStatusPtr->SpiStatusRegister = macphy_spi_status();
+	SpiStatusPtr->Sync = (EthInitDone == TRUE) ? FALSE : TRUE;
+	SpiStatusPtr->BufferStatusTxCredit = macphy_tx_credit();
+	SpiStatusPtr->BufferStatusRxCredit = macphy_rx_pending();
+
+	return E_OK;
+}
+
+
+
+// Reads the list of Tx error counter values
+Std_ReturnType Eth_GetTxErrorCounterValues(uint8 CtrlIdx, Eth_TxErrorCounterValuesType* TxErrorCounterValues) {
 	Std_ReturnType retc = E_NOT_OK;
 
+	if ((EthCfgPtr == NULL) || (CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) || (TxErrorCounterValues == NULL)) {
+		return retc;
+	}
+
+	if (EthCfgPtr[CtrlIdx].general.get_tx_erctv_api == TRUE) {
+		macphy_get_tx_err_counters(TxErrorCounterValues);
+		retc = E_OK;
+	}
+
 	return retc;
+}
+
+
+
+static void Eth_MainFunctionCtrl(uint8 CtrlIdx) {
+	const EthGeneralCfgType* gen = &EthCfgPtr[CtrlIdx].general;
+	Eth_MainFunctionStatsType* stats = &EthMainStats[CtrlIdx];
+	Eth_RxStatusType rx_status = ETH_RECEIVED_MORE_DATA_AVAILABLE;
+	boolean rx_first = EthRxBacklog[CtrlIdx];
+	uint32 start = k_cycle_get_32();
+	uint32 elapsed_us = 0;
+	uint16 frames = 0;
+
+	/* link state, PHY accesses, parked Tx frames and Tx confirmations. These
+	are bounded by the mem-pool size, hence they are done on every call */
+	if (!rx_first) {
+		macphy_periodic_fn();
+		Eth_TxConfirmation(CtrlIdx);
+	}
+
+	/* drain the received frames within the budget, the Tx FIFO is served
+	between them so that it does not wait for the next call */
+	while ((rx_status == ETH_RECEIVED_MORE_DATA_AVAILABLE) &&
+	       (frames < gen->mainfn_bdgt_frm) && (elapsed_us < gen->mainfn_bdgt_us)) {
+#if MACPHY_RX_PIPE_ENABLE == 1
+		/* only read into the pipe, Eth_RxPipeDeliver indicates the frames */
+		if (macphy_rxpipe_io(1) == 0) {
+			rx_status = ETH_NOT_RECEIVED;
+		}
+		else {
+			rx_status = (macphy_rx_pending()) ? ETH_RECEIVED_MORE_DATA_AVAILABLE : ETH_RECEIVED;
+		}
+#else
+		Eth_Receive(CtrlIdx, 0, &rx_status);
+#endif
+		if (rx_status != ETH_NOT_RECEIVED) {
+			frames++;
+		}
+		macphy_tx_service();
+		Eth_TxConfirmation(CtrlIdx);
+		elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	}
+
+	/* the frames left in the MACPHY are read first on the next call */
+	EthRxBacklog[CtrlIdx] = (rx_status == ETH_RECEIVED_MORE_DATA_AVAILABLE) ? TRUE : FALSE;
+
+	if (rx_first) {
+		macphy_periodic_fn();
+		Eth_TxConfirmation(CtrlIdx);
+	}
+
+	/* work accounting */
+	elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	stats->Calls++;
+	stats->LastFrames = frames;
+	stats->LastTimeUs = elapsed_us;
+	if (frames > stats->MaxFrames) {
+		stats->MaxFrames = frames;
+	}
+	if (elapsed_us > stats->MaxTimeUs) {
+		stats->MaxTimeUs = elapsed_us;
+	}
+	if (EthRxBacklog[CtrlIdx]) {
+		stats->Overruns++;
+	}
+}
+
+
+
+// Called every general.mainfn_period_ms, handles the Rx, Tx and link state of
+// all controllers within the frame and time budget of each controller
+void Eth_MainFunction(void) {
+	uint8 i;
+
+	if (EthCfgPtr == NULL) {
+		return;
+	}
+
+	for (i = 0; i < ETH_DRIVER_MAX_CHANNEL; i++) {
+		if (EthCfgPtr[i].ctrlcfg.enable_mii == TRUE) {
+			Eth_MainFunctionCtrl(i);
+		}
+	}
+}
+
+
+
+Std_ReturnType Eth_GetMainFunctionStats(uint8 CtrlIdx, Eth_MainFunctionStatsType* StatsPtr) {
+	if ((CtrlIdx >= ETH_DRIVER_MAX_CHANNEL) || (StatsPtr == NULL)) {
+		return E_NOT_OK;
+	}
+
+	*StatsPtr = EthMainStats[CtrlIdx];
+
+	return E_OK;
 }
\ No newline at end of file
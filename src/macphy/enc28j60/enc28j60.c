@@ -27,6 +27,8 @@
 
 #include "enc28j60.h"
 #include <macphy_mpool.h>
+#include <macphy_trace.h>
+#include <macphy_txq.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(enc28j60, LOG_LEVEL_DBG);
@@ -36,14 +38,73 @@ LOG_MODULE_REGISTER(enc28j60, LOG_LEVEL_DBG);
 #define ADDL_ENC28J60_DEBUG_PRINTS      0
 #define ADDL_ENC28J60_ERROR_CHECKS      0
 
+// set this to 0 to remove the SPI bus utilization counters
+#define ENC28J60_SPI_PROFILING          1
+
+// number of times a frame aborted by the MAC is re-transmitted before dropping
+#define ENC28J60_TX_ABORT_RETRIES       3
+
+// Rx flow control: in full duplex, PAUSE frames are sent while the Rx buffer
+// fill (in bytes) is above the high watermark, until it drops below the low
+// watermark. Set ENC28J60_RX_FLOW_CONTROL to 0 to disable the PAUSE frames.
+#define ENC28J60_RX_FLOW_CONTROL        1
+#define ENC28J60_RX_HI_WATERMARK        (RX_BUF_SZ * 3 / 4)
+#define ENC28J60_RX_LO_WATERMARK        (RX_BUF_SZ / 4)
+#define ENC28J60_PAUSE_QUANTA           (0x1000) /* EPAUS, in units of 512 bit times */
+
+// ARP and ICMP echo requests to our IP are answered from within the MACPHY,
+// see enc28j60_fast_respond. Active once enc28j60_set_fast_resp_ip is called.
+#define ENC28J60_FAST_RESPONDER         1
+
+// Cyclic Tx streams: headers are written once into a slot of the Tx memory,
+// see enc28j60_stream_register. Set to 0 to remove the streams.
+#define ENC28J60_TX_STREAMS             4
+
+// Adaptive Rx: interrupt driven (PKTIE) at low load. A burst, i.e., EPKTCNT
+// reaching the coalescing frames or two interrupts closer than the coalescing
+// time, masks PKTIE and EPKTCNT is polled until it is 0 or the poll budget is
+// used up, then PKTIE is unmasked again. See enc28j60_set_rx_coalescing.
+#define ENC28J60_COALESCE_FRAMES        (4)
+#define ENC28J60_COALESCE_USEC          (200)
+#define ENC28J60_POLL_BUDGET            (64)
+
+// Whole frame operations as one SPI sequence of jobs (see enc28j60_spi_chain).
+// Needs SEQ_ETHERNET_TX_FRAME, SEQ_ETHERNET_RX_HEAD and SEQ_ETHERNET_RX_TAIL
+// in the Spi configuration, with the job i of each using the channel i.
+#define ENC28J60_SPI_CHAINED            0
+
+// Gathered Tx: each fragment is written by its own WBM, as one job of the
+// opcode channel (0) and the fragment channel (1) in SEQ_ETHERNET_WBM_SG.
+// With 0, the fragments are flattened into a Tx pool by macphy_frags_send.
+// Off by default, as SEQ_ETHERNET_WBM_SG isn't in the default Spi config.
+#define ENC28J60_TX_GATHER              0
+
+// Large RBM / WBM are split into chunks of this many bytes, with the bus given
+// up in between (see enc28j60_spi_arbitrate), to bound the time the other
+// users of the SPI bus wait. 0 moves a frame in one transfer. Tx FIFO frames
+// of ENC28J60_EXPRESS_PRIO and up may go out in the middle of an Rx read.
+// Not used with ENC28J60_SPI_CHAINED, as a chain is one sequence anyway.
+#define ENC28J60_SPI_CHUNK_LEN          (0)
+#define ENC28J60_EXPRESS_PRIO           (6)
+
+// Software timestamps refer to the SFD on the wire: the Rx capture is at the
+// end of the frame, the Tx capture is at TXRTS, 8 bytes ahead of the SFD end
+#define ENC28J60_NS_PER_BYTE            (800) /* 10 Mbps */
+#define ENC28J60_TX_SFD_NS              (8 * ENC28J60_NS_PER_BYTE)
+
 
 // Memory Buffer Layout (8k)
 #define BUFFER_BEG	(0x0000)
 #define BUFFER_END	(0x1FFF)
 #define TX_BUF_BEG	(BUFFER_BEG)
 #define TX_BUF_END	(0x0FFF)
+#define FR_TX_BEG	(0x0800) /* 0x0800 - 0x0BFF is for the fast responder */
+#define FR_TX_SZ	(0x0400)
+#define STRM_TX_BEG	(0x0C00) /* 0x0C00 - 0x0FFF are the Tx stream slots */
+#define STRM_SLOT_SZ	(0x0100)
 #define RX_BUF_BEG	(0x1000)
 #define RX_BUF_END	(BUFFER_END)
+#define RX_BUF_SZ	(RX_BUF_END - RX_BUF_BEG + 1)
 
 #define TX_VECT_SZ      (8)
 #define RX_VECT_SZ      (4)
@@ -60,35 +121,175 @@ static uint8  MAC_RevId;
 typedef enum {
         MACPHY_RESET = 0x00,
         MACPHY_LINK_UP = 0x01,
+        MACPHY_FULL_DUPLEX = 0x02,
         MAX_MACPHY_STATE
 }MacPhyState_t;
 
 static MacPhyState_t MacPhy_state;
+static enc28j60_link_info_t LinkInfo;
+
+
+// Transmit status tracking
+static uint16 TxLastEnd;        /* ETXND of the last frame, TSV is at ETXND+1 */
+static boolean TxTsvPending;    /* TSV of the last frame is not yet read */
+static uint8  TxAbortRetries;
+static uint32 TxLastSeq;
+static uint32 RxFrameSeq;
+static uint8  RxPktsPending;    /* frames left in MACPHY after the last read */
+static uint16 RxRdPtr;          /* start of the unread Rx data, = ERXRDPT once a frame is read */
+static uint8  MacAddr[6];
+
+/* read along with the Rx status, for the classifier and the fast responder */
+#define RX_PREFIX_SZ    (MACPHY_RX_PREFIX_SZ)
+static macphy_rx_classify_t RxClassifier;
+static enc28j60_rx_class_stats_t RxClassStats;
+
+#if ENC28J60_FAST_RESPONDER == 1
+#define FR_HDR_SZ       (42) /* Eth + ARP, or Eth + IPv4 (no options) + ICMP header */
+static uint8   FastRespIp[4];
+static boolean FastRespEn;
+static enc28j60_fast_resp_stats_t FastRespStats;
+#endif
+
+#if ENC28J60_TX_STREAMS > 0
+typedef struct {
+        boolean used;
+        uint16  hdr_len;
+        uint16  ip_ofs;         /* 0 if no IPv4 header */
+        uint16  udp_ofs;        /* 0 if no UDP header */
+        uint16  ip_id;
+        uint32  ip_sum;         /* IPv4 header sum without length, ID and checksum */
+} enc28j60_stream_t;
+
+static enc28j60_stream_t TxStreams[ENC28J60_TX_STREAMS];
+#endif
+
+static enc28j60_rx_flow_t RxFlow = {
+        .hi_mark = ENC28J60_RX_HI_WATERMARK,
+        .lo_mark = ENC28J60_RX_LO_WATERMARK
+};
+static enc28j60_rx_mode_t RxMode = {
+        .coal_frames = ENC28J60_COALESCE_FRAMES,
+        .coal_usec = ENC28J60_COALESCE_USEC,
+        .poll_budget = ENC28J60_POLL_BUDGET
+};
+static uint32 RxIrqStamp;       /* cycles of the oldest unserved interrupt, 0 = none */
+static uint32 RxIrqLast;        /* cycles of the last interrupt */
+static boolean RxIrqBurst;      /* interrupts came faster than coal_usec */
+static uint16 RxPollCnt;        /* frames read since polling started */
+static Eth_TxErrorCounterValuesType TxErrCounters;
+static enc28j60_telemetry_t Telemetry;
+static macphy_ts_t RxTs;        /* ingress timestamp of the frame being read */
+static uint32 RxTsObs;          /* cycles at the last EPKTCNT read */
+static uint32 RxTsEmpty;        /* cycles at the last EPKTCNT read that left no older frame */
+static uint32 LinkDownPendStart; /* uptime when Tx frames began to wait for the link, 0 = not waiting */
 
 
 // Frame configs
 #define MAX_ETH_FRAME_LEN	(MEM_POOL_BUF_LEN)
-#define ENC28J60_BASIC_MSG_LEN	(32)
+#define ENC28J60_BASIC_MSG_LEN	(64)
 
 uint8 SpiEthBasicTx[ENC28J60_BASIC_MSG_LEN];
 uint8 SpiEthBasicRx[ENC28J60_BASIC_MSG_LEN];
 
 
+// SPI bus utilization
+#if ENC28J60_SPI_PROFILING == 1
+static enc28j60_spi_prof_t SpiProf;
+#endif
+static boolean SpiInPhyAccess; /* register accesses are done for a PHY R/W */
+static uint8 SpiBank;           /* bank selected in ECON1 */
+static uint32 SpiMaxBlockCyc;   /* longest Spi_SyncTransmit */
+static uint16 SpiMaxBlockLen;
+
+static enc28j60_spi_arb_t SpiArb = {
+        .chunk_len = ENC28J60_SPI_CHUNK_LEN,
+        .express_prio = ENC28J60_EXPRESS_PRIO
+};
+static enc28j60_spi_arb_cbk_t SpiArbCbk;
+static boolean SpiInArb;        /* an express frame is sent from an arbitration point */
+
+#if ENC28J60_SPI_CHAINED == 1
+#define SPI_CHAIN_MAX_JOBS      (12)
+#define TX_CHAIN_JOBS           (11)
+#define RX_HEAD_JOBS            (4)
+#define RX_TAIL_JOBS            (5)
+
+typedef struct {
+        uint8 *tx;
+        uint8 *rx;
+        uint16 len;
+        uint16 payload;
+        enc28j60_spi_cat_t cat;
+} enc28j60_spi_job_t;
+
+static enc28j60_spi_job_t SpiChain[SPI_CHAIN_MAX_JOBS];
+static uint8 SpiChainCmd[SPI_CHAIN_MAX_JOBS][2];
+static uint8 SpiChainRsp[SPI_CHAIN_MAX_JOBS][2];
+static uint8 SpiChainTsvTx[TSV_SZ+1];
+static uint8 SpiChainTsvRx[TSV_SZ+1];
+static uint8 SpiChainLen;
+#endif
+
+
 // Local function prototypes
 boolean enc28j60_write_mem(spi_mpool_t *mpool);
-boolean enc28j60_read_mem(spi_mpool_t *mpool);
+boolean enc28j60_read_mem(spi_mpool_t *mpool, enc28j60_spi_cat_t cat);
+void send_pkt_from_mpool(spi_mpool_t *mpool);
 
 
 
 //////////////////////////////////////////////
 // Local Functions
 
+/* All SPI transactions of this driver go through this function, so that the
+** bus usage can be accounted by purpose (cat). len is the number of bytes
+** set up by Spi_SetupEB, out of which payload bytes are Eth frame data. */
+static Std_ReturnType enc28j60_spi_xfer_seq(Spi_SequenceEnumType seq, enc28j60_spi_cat_t cat,
+        uint16 len, uint16 payload) {
+        Std_ReturnType retc;
+        uint32 start = k_cycle_get_32();
+        uint32 busy;
+
+        retc = Spi_SyncTransmit(seq);
+
+        /* worst case time the other bus users had to wait */
+        busy = k_cycle_get_32() - start;
+        if (busy > SpiMaxBlockCyc) {
+                SpiMaxBlockCyc = busy;
+                SpiMaxBlockLen = len;
+        }
+
+#if ENC28J60_SPI_PROFILING == 1
+        SpiProf.busy_cycles += busy;
+        if (SpiInPhyAccess && (cat != SPI_CAT_BANK_SWITCH)) {
+                cat = SPI_CAT_PHY_ACCESS;
+        }
+        SpiProf.xfers[cat]++;
+        SpiProf.bytes[cat] += len;
+        SpiProf.total_bytes += len;
+        SpiProf.payload_bytes += payload;
+#endif
+
+        return retc;
+}
+
+
+static inline Std_ReturnType enc28j60_spi_xfer(enc28j60_spi_cat_t cat, uint16 len, uint16 payload) {
+        return enc28j60_spi_xfer_seq(SEQ_ETHERNET_BASIC_TX_RX, cat, len, payload);
+}
+
+
+static inline enc28j60_spi_cat_t enc28j60_reg_cat(uint16 reg, enc28j60_spi_cat_t eth_cat) {
+        return (reg & 0x8000) ? SPI_CAT_MAC_MII_REG : eth_cat;
+}
+
+
+
 /* This function switches bank based on bits[0:5] - bank number bits
 ** from passed argument (i.e., reg). */
 static inline boolean enc28j60_switch_bank(uint16 reg) {
-        uint8 data;
         uint8 bank;
-        static uint8 bank_old;
 
         // First, return if the target reg is a common register
         if (0x4000 & reg) {
@@ -97,33 +298,35 @@ static inline boolean enc28j60_switch_bank(uint16 reg) {
 
         // check if it is required to switch the bank
         bank = ((reg & 0x3F00) >> 8);
-        if (bank == bank_old) {
+        if (bank == SpiBank) {
                 return TRUE; // already switched
         }
 
         /* For the up-comming transmission, we just need to send 1+1 byte */
         Spi_SetupEB(0, SpiEthBasicTx, SpiEthBasicRx, 2);
 
-        /* Read ECON1 register */
-        SpiEthBasicTx[0] = (uint8) ((RD_REG_OPCODE) | (ECON1));
-        SpiEthBasicTx[1] = 0; // dummy
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        /* Clear the bank bits of ECON1. Only bit ops are used, a read and write
+        of ECON1 would set TXRTS again if the MAC ends a frame in between. */
+        SpiEthBasicTx[0] = (uint8) ((BT_CLR_OPCODE) | (ECON1));
+        SpiEthBasicTx[1] = ECON1_BSEL1 | ECON1_BSEL0;
+        if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_BANK_SWITCH, 2, 0)) {
                 LOG_ERR("%s: Spi Sync Tx failure[1]!", __func__);
                 return FALSE;
         }
-        data = SpiEthBasicRx[1] & 0xFC; // remove last 2 bits & read
-
-
-        /* Write ECON1 register with target bank bits */
-        SpiEthBasicTx[0] = (uint8) ((WR_REG_OPCODE) | (ECON1));
-        SpiEthBasicTx[1] = data | (bank & 0x03);
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
-                LOG_ERR("%s: Spi Sync Tx failure[2]!", __func__);
-                return FALSE;
+        SpiBank = 0;
+
+        /* Set the target bank bits */
+        if (bank & 0x03) {
+                SpiEthBasicTx[0] = (uint8) ((BT_SET_OPCODE) | (ECON1));
+                SpiEthBasicTx[1] = bank & 0x03;
+                if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_BANK_SWITCH, 2, 0)) {
+                        LOG_ERR("%s: Spi Sync Tx failure[2]!", __func__);
+                        return FALSE;
+                }
         }
 
         /* Store old bank value to prevent bank switching if it is already switched */
-        bank_old = bank;
+        SpiBank = bank;
 
         return TRUE;
 }
@@ -149,7 +352,7 @@ uint8 enc28j60_read_reg(uint16 reg) {
 
         SpiEthBasicTx[0] = (uint8) ((RD_REG_OPCODE) | (reg & 0xff));
         SpiEthBasicTx[dlen-1] = 0x00; // dummy 2nd byte for MII or MAC registers
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        if (E_NOT_OK == enc28j60_spi_xfer(enc28j60_reg_cat(reg, SPI_CAT_CTRL_REG_RD), dlen, 0)) {
                 LOG_ERR("%s: Spi Sync Tx failure!", __func__);
                 return 0xFF;
         }
@@ -172,7 +375,7 @@ boolean enc28j60_write_reg(uint16 reg, uint8 data) {
 
         SpiEthBasicTx[0] = (uint8) ((WR_REG_OPCODE) | (reg & 0xff));
         SpiEthBasicTx[dlen-1] = data;
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        if (E_NOT_OK == enc28j60_spi_xfer(enc28j60_reg_cat(reg, SPI_CAT_CTRL_REG_WR), dlen, 0)) {
                 LOG_ERR("%s: Spi Sync Tx failure!", __func__);
                 return FALSE;
         }
@@ -185,7 +388,7 @@ boolean enc28j60_sys_cmd(uint8 cmd) {
         /* For the up-comming transmission, we just need to send 1 byte */
         Spi_SetupEB(0, SpiEthBasicTx, SpiEthBasicRx, 1);
         SpiEthBasicTx[0] = (uint8) (cmd);
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_SYS_CMD, 1, 0)) {
                 LOG_ERR("%s: Spi Sync Tx failure!", __func__);
                 return FALSE;
         }
@@ -214,7 +417,7 @@ static inline boolean enc28j60_bit_ops_reg(uint8 opcode, uint16 reg, uint8 data)
 
         SpiEthBasicTx[0] = (uint8) ((opcode) | (reg & 0xff));
         SpiEthBasicTx[dlen-1] = data;
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_BIT_SET_CLR, dlen, 0)) {
                 LOG_ERR("%s: Spi Sync Tx failure!", __func__);
                 return FALSE;
         }
@@ -236,11 +439,16 @@ boolean enc28j60_bitclr_reg(uint16 reg, uint8 data) {
 
 //////////////////////////////////////////////
 // Basic ENC28J60 Primitive - PHY R/W
+// Note: these block the caller for 10.24 us, so after enc28j60_init the non-
+// blocking enc28j60_read_phy_async / enc28j60_write_phy_async are used.
 boolean enc28j60_check_phy_busy(void) {
         boolean phy_busy = FALSE; // lets assume that PHY is idle
+        boolean in_phy = SpiInPhyAccess;
         uint8 mstat;
 
+        SpiInPhyAccess = TRUE;
         mstat = enc28j60_read_reg(MISTAT);
+        SpiInPhyAccess = in_phy;
         if (mstat & MISTAT_BUSY) {
                 LOG_WRN("A PHY register is currently being read or written to!");
                 phy_busy = TRUE;
@@ -269,6 +477,7 @@ uint16 enc28j60_read_phy(uint8 phyaddr) {
                 LOG_ERR("Eth. PHY is busy - 1");
                 return 0xffff;
         }
+        SpiInPhyAccess = TRUE;
 
         // write the address of the PHY register to read
         enc28j60_write_reg(MIREGADR, phyaddr);
@@ -280,6 +489,7 @@ uint16 enc28j60_read_phy(uint8 phyaddr) {
         k_sleep(K_USEC(11));
         if (enc28j60_check_phy_busy()) {
                 LOG_ERR("Eth. PHY is busy - 2");
+                SpiInPhyAccess = FALSE;
                 return 0xffff;
         }
 
@@ -289,6 +499,7 @@ uint16 enc28j60_read_phy(uint8 phyaddr) {
         // read desired data from MIRDL and MIRDH (order is important)
         low = enc28j60_read_reg(MIRDL);
         hig = enc28j60_read_reg(MIRDH);
+        SpiInPhyAccess = FALSE;
 
         return (hig << 8 | low);
 }
@@ -296,12 +507,15 @@ uint16 enc28j60_read_phy(uint8 phyaddr) {
 
 
 boolean enc28j60_write_phy(uint8 phyaddr, uint16 data) {
+        SpiInPhyAccess = TRUE;
+
         // write the address of the PHY register to read
         enc28j60_write_reg(MIREGADR, phyaddr);
 
         // write data low and high bytes
         enc28j60_write_reg(MIWRL, (uint8)(data & 0xff));
         enc28j60_write_reg(MIWRH, (uint8)(data >> 8));
+        SpiInPhyAccess = FALSE;
 
         // wait 10.24us and poll MSTAT.BUSY bit
         k_sleep(K_USEC(11));
@@ -317,7 +531,79 @@ boolean enc28j60_write_phy(uint8 phyaddr, uint16 data) {
 
 //////////////////////////////////////////////
 // Basic ENC28J60 Primitive - Memory R/W
-boolean enc28j60_read_mem(spi_mpool_t *mpool) {
+
+/* Called between the chunks of a RBM / WBM, the bus is free here. The hook
+** may run the SPI jobs of the other devices. In a RBM, an express frame of
+** the Tx FIFO is sent at once if the MAC is free; the TSV read on the way
+** moves ERDPT, hence it is put back for the rest of the read. */
+static void enc28j60_spi_arbitrate(boolean in_rbm) {
+        spi_mpool_t *mpool;
+        uint16 erdpt;
+
+        SpiArb.arb_points++;
+        if (SpiArbCbk != NULL) {
+                SpiArbCbk();
+        }
+
+        mpool = peek_spi_mpool_w_data();
+        if (!in_rbm || SpiInArb || (mpool == NULL) || (mpool->prio < SpiArb.express_prio) ||
+                ((MacPhy_state & MACPHY_LINK_UP) == 0) || (enc28j60_read_reg(ECON1) & ECON1_TXRTS)) {
+                return;
+        }
+
+        SpiInArb = TRUE;
+        erdpt = enc28j60_read_reg(ERDPTL);
+        erdpt |= (enc28j60_read_reg(ERDPTH) << 8);
+        send_pkt_from_mpool(get_spi_mpool_w_data());
+        enc28j60_write_reg(ERDPTL, LO_BYTE(erdpt));
+        enc28j60_write_reg(ERDPTH, HI_BYTE(erdpt));
+        SpiArb.express_frames++;
+        SpiInArb = FALSE;
+}
+
+
+
+/* RBM / WBM of the len bytes at tx+1 / rx+1 in chunks of SpiArb.chunk_len,
+** tx[0] has the opcode. ERDPT / EWRPT auto-increment, so each chunk goes on
+** where the last one ended. The byte in front of a chunk is borrowed for the
+** opcode and put back after it. The first len - payload bytes are not frame
+** data (e.g., the per-packet control byte). */
+static boolean enc28j60_mem_chunked(uint8 *tx, uint8 *rx, uint16 len, enc28j60_spi_cat_t cat,
+        uint16 payload, boolean in_rbm) {
+        uint16 ofs = 0, n, p;
+        uint16 skip = len - payload;
+        uint8 save_tx, save_rx;
+        Std_ReturnType retc;
+
+        while (ofs < len) {
+                n = ((len - ofs) > SpiArb.chunk_len) ? SpiArb.chunk_len : (len - ofs);
+                p = (skip < n) ? (n - skip) : 0;
+                skip -= (n - p);
+
+                save_tx = tx[ofs];
+                save_rx = rx[ofs];
+                tx[ofs] = tx[0];
+                Spi_SetupEB(0, tx+ofs, rx+ofs, n+1);
+                retc = enc28j60_spi_xfer(cat, n+1, p);
+                tx[ofs] = save_tx;
+                rx[ofs] = save_rx;
+                if (E_NOT_OK == retc) {
+                        return FALSE;
+                }
+
+                SpiArb.chunks++;
+                ofs += n;
+                if (ofs < len) {
+                        enc28j60_spi_arbitrate(in_rbm);
+                }
+        }
+
+        return TRUE;
+}
+
+
+
+boolean enc28j60_read_mem(spi_mpool_t *mpool, enc28j60_spi_cat_t cat) {
         uint16 dlen = mpool->dlen;
 
         /* check if data+1-byte_read opcode can fit into Rx Buffer */
@@ -334,14 +620,240 @@ boolean enc28j60_read_mem(spi_mpool_t *mpool) {
 
         /* Do the SPI reception */
         mpool->tx_buf[0] = (uint8) (RD_MEM_OPCODE);
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        if ((SpiArb.chunk_len > 0) && (dlen > SpiArb.chunk_len)) {
+                if (FALSE == enc28j60_mem_chunked(mpool->tx_buf, mpool->rx_buf, dlen, cat,
+                        (cat == SPI_CAT_RBM_PAYLOAD) ? dlen : 0, TRUE)) {
+                        LOG_ERR("%s: Spi Sync Rx failure!", __func__);
+                        return FALSE;
+                }
+                return TRUE;
+        }
+        if (E_NOT_OK == enc28j60_spi_xfer(cat, dlen+1, (cat == SPI_CAT_RBM_PAYLOAD) ? dlen : 0)) {
+                LOG_ERR("%s: Spi Sync Rx failure!", __func__);
+                return FALSE;
+        }
+
+
+        return TRUE;
+}
+
+
+
+/* updates the Tx error counters from a transmit status vector */
+static void enc28j60_decode_tsv(const uint8 *tsv) {
+        uint8 colcnt;
+
+        /* decode the vector as per table 7-1 of datasheet */
+        MACPHY_TRACE(TRC_TX_COMPLETE, TxLastSeq);
+        colcnt = tsv[2] & TSV2_COLCNT;
+        if (colcnt == 1) {
+                TxErrCounters.TxSingleCollision++;
+        }
+        else if (colcnt > 1) {
+                TxErrCounters.TxMultipleCollision++;
+        }
+
+        if (tsv[3] & (TSV3_DEFER | TSV3_EXCDEFER)) {
+                TxErrCounters.TxDeferredTrans++;
+        }
+        if (tsv[3] & TSV3_LATECOL) {
+                TxErrCounters.TxLateCollision++;
+        }
+        if (tsv[3] & TSV3_EXCCOL) {
+                TxErrCounters.TxExcessiveCollison++;
+        }
+
+#if ADDL_ENC28J60_DEBUG_PRINTS == 1
+        LOG_DBG("TSV: %02x %02x %02x %02x %02x %02x %02x", tsv[0], tsv[1],
+                tsv[2], tsv[3], tsv[4], tsv[5], tsv[6]);
+#endif
+}
+
+
+
+/* Reads the transmit status vector of the last frame and updates the Tx error
+** counters. Note: the ERDPT writes leave the bank 0 selected. */
+static boolean enc28j60_read_tsv(void) {
+        uint16 tsv_addr = TxLastEnd + 1;
+
+        TxTsvPending = FALSE;
+
+        /* set the read pointer to ETXND+1 */
+        enc28j60_write_reg(ERDPTL, LO_BYTE(tsv_addr));
+        enc28j60_write_reg(ERDPTH, HI_BYTE(tsv_addr));
+
+        /* For the up-comming transaction, we need to send 1 + recv TSV_SZ bytes */
+        Spi_SetupEB(0, SpiEthBasicTx, SpiEthBasicRx, TSV_SZ+1);
+        SpiEthBasicTx[0] = (uint8) (RD_MEM_OPCODE);
+        if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_RBM_STATUS, TSV_SZ+1, 0)) {
+                LOG_ERR("%s: Spi Sync Rx failure!", __func__);
+                return FALSE;
+        }
+
+        enc28j60_decode_tsv(SpiEthBasicRx+1); // +1 for RD_MEM_OPCODE
+
+        return TRUE;
+}
+
+
+
+#if ENC28J60_SPI_CHAINED == 1
+//////////////////////////////////////////////
+// Chained SPI jobs - a whole frame operation is set up as a list of jobs, one
+// per chip select, and given to the SPI driver as a single sequence.
+static inline void enc28j60_chain_cmd(uint8 opcode, uint16 reg, uint8 data, enc28j60_spi_cat_t cat) {
+        enc28j60_spi_job_t *job = &SpiChain[SpiChainLen];
+
+        SpiChainCmd[SpiChainLen][0] = (uint8) (opcode | (reg & 0xff));
+        SpiChainCmd[SpiChainLen][1] = data;
+        job->tx = SpiChainCmd[SpiChainLen];
+        job->rx = SpiChainRsp[SpiChainLen];
+        job->len = 2;
+        job->payload = 0;
+        job->cat = cat;
+        SpiChainLen++;
+}
+
+
+
+/* buf[0] gets the opcode, len includes it */
+static inline void enc28j60_chain_mem(uint8 opcode, uint8 *tx, uint8 *rx, uint16 len,
+        uint16 payload, enc28j60_spi_cat_t cat) {
+        enc28j60_spi_job_t *job = &SpiChain[SpiChainLen];
+
+        tx[0] = opcode;
+        job->tx = tx;
+        job->rx = rx;
+        job->len = len;
+        job->payload = payload;
+        job->cat = cat;
+        SpiChainLen++;
+}
+
+
+
+/* the bank 0 is selected first, as the pointer registers are all in it */
+static inline void enc28j60_chain_begin(void) {
+        SpiChainLen = 0;
+        enc28j60_chain_cmd(BT_CLR_OPCODE, ECON1, ECON1_BSEL1 | ECON1_BSEL0, SPI_CAT_BANK_SWITCH);
+}
+
+
+
+/* runs the chained jobs back to back, the CPU is involved only at the end */
+static Std_ReturnType enc28j60_spi_chain(Spi_SequenceEnumType seq) {
+        Std_ReturnType retc;
+        uint8 i;
+        uint32 start, busy;
+        uint16 len = 0;
+
+        for (i = 0; i < SpiChainLen; i++) {
+                Spi_SetupEB(i, SpiChain[i].tx, SpiChain[i].rx, SpiChain[i].len);
+                len += SpiChain[i].len;
+        }
+        start = k_cycle_get_32();
+        retc = Spi_SyncTransmit(seq);
+        busy = k_cycle_get_32() - start;
+        SpiBank = 0;
+
+        /* the chain holds the bus for all of its jobs */
+        if (busy > SpiMaxBlockCyc) {
+                SpiMaxBlockCyc = busy;
+                SpiMaxBlockLen = len;
+        }
+
+#if ENC28J60_SPI_PROFILING == 1
+        SpiProf.busy_cycles += busy;
+        for (i = 0; i < SpiChainLen; i++) {
+                SpiProf.xfers[SpiChain[i].cat]++;
+                SpiProf.bytes[SpiChain[i].cat] += SpiChain[i].len;
+                SpiProf.total_bytes += SpiChain[i].len;
+                SpiProf.payload_bytes += SpiChain[i].payload;
+        }
+#endif
+
+        return retc;
+}
+
+
+
+/* TSV read of the last frame, Tx pointers and WBM in one sequence. TXRTS is
+** left to the caller, so that the Tx timestamp is not spread over the chain.
+** The TSV is always read to keep the job list fixed, but decoded only if
+** it belongs to a frame that was sent. */
+static boolean enc28j60_tx_chained(spi_mpool_t *mpool) {
+        uint16 tsv_addr = TxLastEnd + 1;
+        uint16 end = TX_BUF_BEG + mpool->dlen; // last frame byte, after the control byte
+
+        enc28j60_chain_begin();
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERDPTL, LO_BYTE(tsv_addr), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERDPTH, HI_BYTE(tsv_addr), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_mem(RD_MEM_OPCODE, SpiChainTsvTx, SpiChainTsvRx, TSV_SZ+1, 0, SPI_CAT_RBM_STATUS);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ETXSTL, LO_BYTE(TX_BUF_BEG), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ETXSTH, HI_BYTE(TX_BUF_BEG), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ETXNDL, LO_BYTE(end), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ETXNDH, HI_BYTE(end), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, EWRPTL, LO_BYTE(TX_BUF_BEG), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, EWRPTH, HI_BYTE(TX_BUF_BEG), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_mem(WR_MEM_OPCODE, mpool->tx_buf, mpool->rx_buf, mpool->dlen+2,
+                mpool->dlen, SPI_CAT_WBM_PAYLOAD);
+
+        MACPHY_TRACE(TRC_TX_SPI_WR_START, mpool->seq);
+        if (E_NOT_OK == enc28j60_spi_chain(SEQ_ETHERNET_TX_FRAME)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+        MACPHY_TRACE(TRC_TX_SPI_WR_DONE, mpool->seq);
+
+        if (TxTsvPending) {
+                TxTsvPending = FALSE;
+                enc28j60_decode_tsv(SpiChainTsvRx+1); // +1 for RD_MEM_OPCODE
+        }
+        TxLastEnd = end;
+
+        return TRUE;
+}
+
+
+
+/* Rx read pointer and the read of the Rx header (+ prefix) in one sequence */
+static boolean enc28j60_rx_head_chained(spi_mpool_t *mpool, uint16 pktptr) {
+        enc28j60_chain_begin();
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERDPTL, LO_BYTE(pktptr), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERDPTH, HI_BYTE(pktptr), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_mem(RD_MEM_OPCODE, mpool->tx_buf, mpool->rx_buf, mpool->dlen+1,
+                0, SPI_CAT_RBM_STATUS);
+
+        if (E_NOT_OK == enc28j60_spi_chain(SEQ_ETHERNET_RX_HEAD)) {
                 LOG_ERR("%s: Spi Sync Rx failure!", __func__);
                 return FALSE;
         }
 
+        return TRUE;
+}
+
+
+
+/* Rest of the frame (ERDPT continues after the header read), ERXRDPT and
+** PKTDEC in one sequence. With nothing left to read the RBM job carries the
+** opcode only, so that the job list stays fixed. */
+static boolean enc28j60_rx_tail_chained(spi_mpool_t *mpool, uint16 rest, uint16 nxtpkt) {
+        SpiChainLen = 0;
+        enc28j60_chain_mem(RD_MEM_OPCODE, mpool->tx_buf, mpool->rx_buf, rest+1, rest,
+                SPI_CAT_RBM_PAYLOAD);
+        enc28j60_chain_cmd(BT_CLR_OPCODE, ECON1, ECON1_BSEL1 | ECON1_BSEL0, SPI_CAT_BANK_SWITCH);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERXRDPTL, LO_BYTE(nxtpkt), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(WR_REG_OPCODE, ERXRDPTH, HI_BYTE(nxtpkt), SPI_CAT_CTRL_REG_WR);
+        enc28j60_chain_cmd(BT_SET_OPCODE, ECON2, ECON2_PKTDEC, SPI_CAT_BIT_SET_CLR);
+
+        if (E_NOT_OK == enc28j60_spi_chain(SEQ_ETHERNET_RX_TAIL)) {
+                LOG_ERR("%s: Spi Sync Rx failure!", __func__);
+                return FALSE;
+        }
 
         return TRUE;
 }
+#endif
 
 
 
@@ -361,51 +873,319 @@ boolean enc28j60_write_mem(spi_mpool_t *mpool) {
                 return FALSE;
         }
 
+        /* the new frame will overwrite the TSV of the last frame, fetch it now.
+        This also selects the bank 0 for the Tx pointer writes below. */
+        if (TxTsvPending) {
+                enc28j60_read_tsv();
+        }
+
         /* always move the Tx write pointer to start of the Tx memory */
         enc28j60_write_reg(ETXSTL, LO_BYTE(TX_BUF_BEG));
         enc28j60_write_reg(ETXSTH, HI_BYTE(TX_BUF_BEG));
-        enc28j60_write_reg(ETXNDL, LO_BYTE(TX_BUF_BEG+dlen+1));
-        enc28j60_write_reg(ETXNDH, HI_BYTE(TX_BUF_BEG+dlen+1));
+        enc28j60_write_reg(ETXNDL, LO_BYTE(TX_BUF_BEG+dlen)); // last frame byte, after the control byte
+        enc28j60_write_reg(ETXNDH, HI_BYTE(TX_BUF_BEG+dlen));
         enc28j60_write_reg(EWRPTL, LO_BYTE(TX_BUF_BEG));
         enc28j60_write_reg(EWRPTH, HI_BYTE(TX_BUF_BEG));
+        TxLastEnd = TX_BUF_BEG+dlen;
 
         /* For the up-comming transmission, we just need to send/recv 1+1 byte */
         Spi_SetupEB(0, mpool->tx_buf, mpool->rx_buf, dlen+2);
 
 
         /* Do the SPI transfer */
-        if (E_NOT_OK == Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX)) {
+        MACPHY_TRACE(TRC_TX_SPI_WR_START, mpool->seq);
+        if ((SpiArb.chunk_len > 0) && (dlen+1 > SpiArb.chunk_len)) {
+                if (FALSE == enc28j60_mem_chunked(mpool->tx_buf, mpool->rx_buf, dlen+1,
+                        SPI_CAT_WBM_PAYLOAD, dlen, FALSE)) {
+                        LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                        return FALSE;
+                }
+        }
+        else if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_WBM_PAYLOAD, dlen+2, dlen)) {
                 LOG_ERR("%s: Spi Sync Tx failure!", __func__);
                 return FALSE;
         }
+        MACPHY_TRACE(TRC_TX_SPI_WR_DONE, mpool->seq);
 
         return TRUE;
 }
 
 
 
-static MacPhyState_t read_enc28j60_phstat_regs(void) {
-	uint16 phy_reg;
-
-	phy_reg = enc28j60_read_phy(PHSTAT1);
-	LOG_DBG("\tPHSTAT1: 0x%04x", phy_reg);
-        if (phy_reg & 0x04) {
-                if (!(MacPhy_state & MACPHY_LINK_UP)) {
-                        MacPhy_state |= MACPHY_LINK_UP;
-                        LOG_INF("Ethernet Link Up!");
-                }
+/* Updates MacPhy_state from the cached PHSTAT1 / PHSTAT2 values. PHSTAT2 has
+** the real-time status, PHSTAT1.LLSTAT latches low until it is read, i.e., it
+** also reports a link loss that has recovered before PHSTAT2 could show it. */
+static void enc28j60_update_link_state(boolean phstat1_read) {
+        static boolean link_loss_seen = TRUE; // ignore the latch from reset
+        MacPhyState_t old_state = MacPhy_state;
+
+        if (LinkInfo.phstat2 & PHSTAT2_LSTAT) {
+                MacPhy_state |= MACPHY_LINK_UP;
         }
         else {
                 MacPhy_state &= ~MACPHY_LINK_UP;
         }
 
-        // TODO: read PHSTAT2 register and update MacPhy_state bits
+        if (LinkInfo.phstat2 & PHSTAT2_DPXSTAT) {
+                MacPhy_state |= MACPHY_FULL_DUPLEX;
+        }
+        else {
+                MacPhy_state &= ~MACPHY_FULL_DUPLEX;
+        }
+        LinkInfo.link_up = (MacPhy_state & MACPHY_LINK_UP) ? TRUE : FALSE;
+        LinkInfo.full_duplex = (MacPhy_state & MACPHY_FULL_DUPLEX) ? TRUE : FALSE;
+
+        if ((old_state & MACPHY_LINK_UP) && !(MacPhy_state & MACPHY_LINK_UP)) {
+                LinkInfo.flaps++;
+                LinkInfo.last_flap_ms = k_uptime_get_32();
+                link_loss_seen = TRUE;
+        }
+        else if (phstat1_read && !link_loss_seen && !(LinkInfo.phstat1 & PHSTAT1_LLSTAT)) {
+                LinkInfo.flaps++;
+                LinkInfo.last_flap_ms = k_uptime_get_32();
+        }
+
+        if (phstat1_read) {
+                link_loss_seen = FALSE; // PHSTAT1.LLSTAT is re-armed by the read
+        }
+
+        if ((old_state ^ MacPhy_state) & MACPHY_LINK_UP) {
+                LinkInfo.last_change_ms = k_uptime_get_32();
+                if (MacPhy_state & MACPHY_LINK_UP) {
+                        LOG_INF("Ethernet Link Up! (%s duplex)",
+                                (MacPhy_state & MACPHY_FULL_DUPLEX) ? "full" : "half");
+                }
+                else {
+                        LOG_INF("Ethernet Link Down!");
+                }
+        }
+}
+
+
+
+/* Blocking read of the PHY status, to be used only from enc28j60_init */
+static MacPhyState_t read_enc28j60_phstat_regs(void) {
+        uint16 phstat1, phstat2;
+
+        phstat1 = enc28j60_read_phy(PHSTAT1);
+        phstat2 = enc28j60_read_phy(PHSTAT2);
+        if ((phstat1 == 0xffff) || (phstat2 == 0xffff)) {
+                return MacPhy_state; // PHY busy, keep the last known state
+        }
+        LinkInfo.phstat1 = phstat1;
+        LinkInfo.phstat2 = phstat2;
+        enc28j60_update_link_state(TRUE);
 
         return MacPhy_state;
 }
 
 
 
+//////////////////////////////////////////////
+// Non-blocking PHY access
+//
+// Once the MACPHY is initialized, the PHY registers are accessed only through
+// the below queue, served by enc28j60_phy_service() from the periodic function
+// without any sleep. While the queue is empty, the MII scan mode keeps PHSTAT2
+// in MIRD, so a link status check is just a MIRDL + MIRDH read.
+#define PHY_OPQ_SIZE            (4) /* must be a power of 2 */
+#define PHY_SM_MAX_STEPS        (4) /* state transitions per service call */
+
+typedef enum {
+        PHY_SM_IDLE,
+        PHY_SM_SCAN,
+        PHY_SM_STOP_SCAN,
+        PHY_SM_RD_BUSY,
+        PHY_SM_WR_BUSY,
+        MAX_PHY_SM_STATE
+} PhySmState_t;
+
+typedef struct {
+        enc28j60_phy_cbk_t done;
+        uint16  data;
+        uint8   phyaddr;
+        boolean write;
+} PhyOp_t;
+
+static PhyOp_t PhyOpQ[PHY_OPQ_SIZE];
+static uint8 PhyOpHead, PhyOpTail;
+static PhySmState_t PhySm;
+static boolean PhyIrqPending;
+
+
+static boolean enc28j60_phy_enqueue(uint8 phyaddr, boolean write, uint16 data, enc28j60_phy_cbk_t done) {
+        PhyOp_t *op;
+
+        if ((uint8)(PhyOpHead - PhyOpTail) >= PHY_OPQ_SIZE) {
+                return FALSE;
+        }
+
+        op = &PhyOpQ[PhyOpHead & (PHY_OPQ_SIZE-1)];
+        op->phyaddr = phyaddr;
+        op->write = write;
+        op->data = data;
+        op->done = done;
+        PhyOpHead++;
+
+        return TRUE;
+}
+
+
+boolean enc28j60_read_phy_async(uint8 phyaddr, enc28j60_phy_cbk_t done) {
+        return enc28j60_phy_enqueue(phyaddr, FALSE, 0, done);
+}
+
+
+boolean enc28j60_write_phy_async(uint8 phyaddr, uint16 data, enc28j60_phy_cbk_t done) {
+        return enc28j60_phy_enqueue(phyaddr, TRUE, data, done);
+}
+
+
+static void enc28j60_phy_start_op(void) {
+        PhyOp_t *op = &PhyOpQ[PhyOpTail & (PHY_OPQ_SIZE-1)];
+
+        enc28j60_write_reg(MIREGADR, op->phyaddr);
+        if (op->write) {
+                enc28j60_write_reg(MIWRL, LO_BYTE(op->data));
+                enc28j60_write_reg(MIWRH, HI_BYTE(op->data)); // starts the MII write
+                PhySm = PHY_SM_WR_BUSY;
+        }
+        else {
+                enc28j60_write_reg(MICMD, MICMD_MIIRD);
+                PhySm = PHY_SM_RD_BUSY;
+        }
+}
+
+
+static void enc28j60_phy_start_scan(void) {
+        enc28j60_write_reg(MIREGADR, PHSTAT2);
+        enc28j60_write_reg(MICMD, MICMD_MIISCAN);
+        PhySm = PHY_SM_SCAN;
+}
+
+
+static void enc28j60_phy_op_done(uint16 data) {
+        PhyOp_t *op = &PhyOpQ[PhyOpTail & (PHY_OPQ_SIZE-1)];
+        enc28j60_phy_cbk_t done = op->done;
+        uint8 phyaddr = op->phyaddr;
+
+        PhyOpTail++;
+        if (PhyOpHead != PhyOpTail) {
+                enc28j60_phy_start_op();
+        }
+        else {
+                enc28j60_phy_start_scan();
+        }
+
+        if (done) {
+                done(phyaddr, data);
+        }
+}
+
+
+static void enc28j60_phy_service(void) {
+        boolean wait = FALSE;
+        uint8 steps = 0;
+        uint16 data;
+
+        SpiInPhyAccess = TRUE;
+        while (!wait && (steps++ < PHY_SM_MAX_STEPS)) {
+                switch (PhySm) {
+                case PHY_SM_IDLE:
+                        if (PhyOpHead != PhyOpTail) {
+                                enc28j60_phy_start_op();
+                        }
+                        else {
+                                enc28j60_phy_start_scan();
+                        }
+                        break;
+
+                case PHY_SM_SCAN:
+                        if (PhyOpHead != PhyOpTail) {
+                                enc28j60_write_reg(MICMD, 0x00); // stop the scan
+                                PhySm = PHY_SM_STOP_SCAN;
+                                break;
+                        }
+                        /* MIRD holds the latest PHSTAT2 (order is important) */
+                        data = enc28j60_read_reg(MIRDL);
+                        data |= enc28j60_read_reg(MIRDH) << 8;
+                        if (data != LinkInfo.phstat2) {
+                                LinkInfo.phstat2 = data;
+                                enc28j60_update_link_state(FALSE);
+                        }
+                        wait = TRUE;
+                        break;
+
+                case PHY_SM_STOP_SCAN:
+                        if (enc28j60_read_reg(MISTAT) & MISTAT_BUSY) {
+                                wait = TRUE;
+                        }
+                        else {
+                                enc28j60_phy_start_op();
+                        }
+                        break;
+
+                case PHY_SM_RD_BUSY:
+                        if (enc28j60_read_reg(MISTAT) & MISTAT_BUSY) {
+                                wait = TRUE;
+                        }
+                        else {
+                                enc28j60_write_reg(MICMD, 0x00);
+                                data = enc28j60_read_reg(MIRDL);
+                                data |= enc28j60_read_reg(MIRDH) << 8;
+                                enc28j60_phy_op_done(data);
+                        }
+                        break;
+
+                case PHY_SM_WR_BUSY:
+                        if (enc28j60_read_reg(MISTAT) & MISTAT_BUSY) {
+                                wait = TRUE;
+                        }
+                        else {
+                                enc28j60_phy_op_done(PhyOpQ[PhyOpTail & (PHY_OPQ_SIZE-1)].data);
+                        }
+                        break;
+
+                default:
+                        PhySm = PHY_SM_IDLE;
+                        break;
+                }
+        }
+        SpiInPhyAccess = FALSE;
+}
+
+
+static void enc28j60_phir_read_done(uint8 phyaddr, uint16 data) {
+        (void) phyaddr;
+        (void) data; // the read only clears the interrupt
+        PhyIrqPending = FALSE;
+}
+
+
+static void enc28j60_phstat1_read_done(uint8 phyaddr, uint16 data) {
+        (void) phyaddr;
+        LinkInfo.phstat1 = data;
+        enc28j60_update_link_state(TRUE);
+}
+
+
+
+/* The PHY sets EIR.LINKIF on link changes (PHIE.PLNKIE). The link and duplex
+** state itself comes from the scanned PHSTAT2, here PHIR is read to clear the
+** interrupt and PHSTAT1 to catch the short link losses. */
+static void enc28j60_link_service(uint8 eir) {
+        if ((eir & EIR_LINKIF) && !PhyIrqPending) {
+                if (enc28j60_read_phy_async(PHIR, enc28j60_phir_read_done)) {
+                        PhyIrqPending = TRUE;
+                        enc28j60_read_phy_async(PHSTAT1, enc28j60_phstat1_read_done);
+                }
+        }
+
+        enc28j60_phy_service();
+}
+
+
+
 void dump_enc28j60_status_registers(void) {
 	uint8 reg_data;
 
@@ -423,16 +1203,72 @@ void dump_enc28j60_status_registers(void) {
 	reg_data = enc28j60_read_reg(ECOCON);
 	LOG_DBG("\tECOCON: 0x%02x", reg_data);
 
-	// phy register status read
-	read_enc28j60_phstat_regs();
+	// phy register status, as last read by the PHY service
+	LOG_DBG("\tPHSTAT1: 0x%04x", LinkInfo.phstat1);
+	LOG_DBG("\tPHSTAT2: 0x%04x", LinkInfo.phstat2);
+}
+
+
+/* Called when ESTAT.TXABRT is seen. The aborted frame is still in the Tx buffer,
+** hence it is re-transmitted as is until ENC28J60_TX_ABORT_RETRIES is reached.
+** Returns TRUE if the frame is re-transmitted, i.e., the MAC is busy again. */
+static boolean enc28j60_retry_aborted_tx(void) {
+        /* fetch the abort reason before the re-transmission overwrites it */
+        if (TxTsvPending) {
+                enc28j60_read_tsv();
+        }
+
+        /* Errata 12 - reset the transmit logic before a new transmission */
+        enc28j60_bitset_reg(ECON1, ECON1_TXRST);
+        enc28j60_bitclr_reg(ECON1, ECON1_TXRST | ECON1_TXRTS);
+        enc28j60_bitclr_reg(EIR, EIR_TXERIF | EIR_TXIF);
+        enc28j60_bitclr_reg(ESTAT, ESTAT_TXABRT);
+
+        if (TxAbortRetries >= ENC28J60_TX_ABORT_RETRIES) {
+                LOG_ERR("Tx aborted, frame dropped after %d retries", TxAbortRetries);
+                TxErrCounters.TxDroppedErrorPkts++;
+                TxAbortRetries = 0;
+                return FALSE;
+        }
+
+        /* ETXST and ETXND still point to the aborted frame */
+        TxAbortRetries++;
+        enc28j60_bitset_reg(ECON1, ECON1_TXRTS);
+        TxTsvPending = TRUE;
+
+        return TRUE;
 }
 
 
+
 void send_pkt_from_mpool(spi_mpool_t *mpool) {
+        uint32 ts_win;
+
+#if ENC28J60_SPI_CHAINED == 1
+        /* TSV, pointers and pkt copy as one SPI sequence */
+        enc28j60_tx_chained(mpool);
+#else
         /* send the pkt via SPI buffer pool */
         enc28j60_write_mem(mpool);
+#endif
         /* trigger the MAC to send the copied pkg */
+        ts_win = k_cycle_get_32();
         enc28j60_bitset_reg(ECON1, ECON1_TXRTS);
+        /* egress timestamp, the MAC starts at once as it was idle. In half
+        duplex it may defer, hence the window is left open. */
+        macphy_ts_capture(&mpool->tx_ts, ts_win, -ENC28J60_TX_SFD_NS);
+        if ((MacPhy_state & MACPHY_FULL_DUPLEX) == 0) {
+                mpool->tx_ts.err_cyc = 0xFFFFFFFFu;
+        }
+        MACPHY_TRACE(TRC_TX_TXRTS_SET, mpool->seq);
+        TxTsvPending = TRUE;
+        TxAbortRetries = 0;
+        TxLastSeq = mpool->seq;
+        /* confirmed on the handover, the TSV is only read when the next frame
+        needs the Tx buffer, a retry or drop after an abort goes to TxErrCounters */
+        if (mpool->tx_confirm) {
+                put_spi_mpool_tx_done(mpool);
+        }
 
 
         /* Errata 12 - Transmit abort may stall transmit logic, revID <= 4 */
@@ -452,60 +1288,645 @@ void send_pkt_from_mpool(spi_mpool_t *mpool) {
 
 
 
+/* Accounts the time the Tx frames wait in the Tx FIFO for the link */
+static void enc28j60_link_wait_service(void) {
+        uint32 now = k_uptime_get_32();
+        boolean waiting;
+
+        waiting = (get_spi_mpool_tx_queued() > 0) && ((MacPhy_state & MACPHY_LINK_UP) == 0);
+        if (waiting && (LinkDownPendStart == 0)) {
+                LinkDownPendStart = now ? now : 1;
+                Telemetry.link_down_pending++;
+                Telemetry.link_down_last_ms = now;
+        }
+        else if (!waiting && (LinkDownPendStart != 0)) {
+                Telemetry.link_down_pending_ms += now - LinkDownPendStart;
+                LinkDownPendStart = 0;
+        }
+}
+
+
+
+/* Starts the frames of the Tx FIFO, highest prio first, as long as the MAC is
+** free and the link is up. The MAC has one Tx buffer, so the next frame goes
+** once TXRTS of the last one has cleared, which a short frame does within the
+** SPI write of the next. */
+static void enc28j60_tx_fifo_kick(void) {
+        spi_mpool_t *mpool;
+
+        enc28j60_link_wait_service();
+        while ((get_spi_mpool_tx_queued() > 0) && (MacPhy_state & MACPHY_LINK_UP)) {
+                /* check if the MACPHY is busy */
+                if (enc28j60_read_reg(ECON1) & ECON1_TXRTS) {
+                        break;
+                }
+
+                mpool = get_spi_mpool_w_data();
+                if (mpool == NULL) {
+                        break;
+                }
+                send_pkt_from_mpool(mpool);
+
+                /* the Errata 12 workaround clears TXRTS at once, busy can't be
+                told from it on these revisions */
+                if (MAC_RevId <= 4) {
+                        break;
+                }
+        }
+}
+
+
+
+/* Computes the Rx buffer fill from the hardware write pointer (ERXWRPT) and
+** the cached read pointer (ERXRDPT). In full duplex, PAUSE frames are sent
+** while the fill is above the high watermark and stopped below the low one,
+** so that the link partner holds back instead of overflowing the buffer. */
+static void enc28j60_rx_flow_service(void) {
+        uint16 wrptr;
+        uint16 fill;
+        boolean full_duplex;
+
+        /* read even with EPKTCNT at 0, a frame may be coming in */
+        wrptr = enc28j60_read_reg(ERXWRPTL);
+        wrptr |= (enc28j60_read_reg(ERXWRPTH) << 8);
+        if (wrptr >= RxRdPtr) {
+                fill = wrptr - RxRdPtr;
+        }
+        else {
+                fill = RX_BUF_SZ - (RxRdPtr - wrptr);
+        }
+
+        RxFlow.fill = fill;
+        if (fill > RxFlow.peak_fill) {
+                RxFlow.peak_fill = fill;
+        }
+        if ((fill > 0) && (fill >= Telemetry.rx_fill_hwm)) {
+                Telemetry.rx_fill_hwm = fill;
+                Telemetry.rx_fill_hwm_ms = k_uptime_get_32();
+        }
+
+#if ENC28J60_RX_FLOW_CONTROL == 1
+        full_duplex = (MacPhy_state & MACPHY_FULL_DUPLEX) ? TRUE : FALSE;
+        if ((RxFlow.paused == FALSE) && (fill >= RxFlow.hi_mark) && full_duplex) {
+                enc28j60_write_reg(EFLOCON, EFLOCON_FC_XOFF);
+                RxFlow.paused = TRUE;
+                RxFlow.pause_events++;
+        }
+        else if ((RxFlow.paused == TRUE) && ((fill <= RxFlow.lo_mark) || !full_duplex)) {
+                /* a PAUSE with 0 quanta lets the link partner resume at once */
+                enc28j60_write_reg(EFLOCON, full_duplex ? EFLOCON_FC_XON : EFLOCON_FC_OFF);
+                RxFlow.paused = FALSE;
+        }
+#else
+        (void) full_duplex;
+#endif
+}
+
+
+
+/* writes len bytes at spi_tx+1 to the MACPHY memory at addr, spi_tx[0] is
+** for the opcode */
+static boolean enc28j60_write_mem_buf(uint16 addr, uint8 *spi_tx, uint8 *spi_rx, uint16 len) {
+        enc28j60_write_reg(EWRPTL, LO_BYTE(addr));
+        enc28j60_write_reg(EWRPTH, HI_BYTE(addr));
+
+        Spi_SetupEB(0, spi_tx, spi_rx, len+1);
+        spi_tx[0] = (uint8) (WR_MEM_OPCODE);
+        if (E_NOT_OK == enc28j60_spi_xfer(SPI_CAT_WBM_PAYLOAD, len+1, len)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+/* writes a few bytes to the MACPHY memory at addr */
+static boolean enc28j60_write_mem_at(uint16 addr, const uint8 *data, uint16 len) {
+        if (len+1 > ENC28J60_BASIC_MSG_LEN) {
+                return FALSE;
+        }
+
+        memcpy(SpiEthBasicTx+1, data, len);
+        return enc28j60_write_mem_buf(addr, SpiEthBasicTx, SpiEthBasicRx, len);
+}
+
+
+
+/* Checks if the MAC is free to take a new frame and reads the TSV of the
+** last one, as the new frame may overwrite it. */
+static boolean enc28j60_tx_idle(void) {
+        if (enc28j60_read_reg(ECON1) & ECON1_TXRTS) {
+                return FALSE;
+        }
+        if (TxTsvPending) {
+                enc28j60_read_tsv();
+        }
+
+        return TRUE;
+}
+
+
+
+/* transmits the frame of len bytes that is in the Tx memory at beg+1, beg
+** has the per-packet control byte */
+static void enc28j60_tx_start(uint16 beg, uint16 len) {
+        enc28j60_write_reg(ETXSTL, LO_BYTE(beg));
+        enc28j60_write_reg(ETXSTH, HI_BYTE(beg));
+        enc28j60_write_reg(ETXNDL, LO_BYTE(beg+len));
+        enc28j60_write_reg(ETXNDH, HI_BYTE(beg+len));
+        TxLastEnd = beg+len;
+        enc28j60_bitset_reg(ECON1, ECON1_TXRTS);
+        TxTsvPending = TRUE;
+        TxAbortRetries = 0;
+
+        /* Errata 12 - Transmit abort may stall transmit logic, revID <= 4 */
+        if (MAC_RevId <= 4) {
+                enc28j60_bitclr_reg(ECON1, ECON1_TXRTS);
+        }
+}
+
+
+
+#if ENC28J60_FAST_RESPONDER == 1
+static inline uint16 enc28j60_rx_wrap(uint16 addr) {
+        return (addr > RX_BUF_END) ? (addr - RX_BUF_SZ) : addr;
+}
+
+
+
+/* copies len bytes from the Rx buffer at src to the Tx memory at dst within
+** the MACPHY. Source addresses wrap around at the end of the Rx buffer. */
+static boolean enc28j60_dma_copy(uint16 src, uint16 len, uint16 dst) {
+        uint16 end = enc28j60_rx_wrap(src + len - 1);
+        uint8 i;
+
+        enc28j60_write_reg(EDMASTL, LO_BYTE(src));
+        enc28j60_write_reg(EDMASTH, HI_BYTE(src));
+        enc28j60_write_reg(EDMANDL, LO_BYTE(end));
+        enc28j60_write_reg(EDMANDH, HI_BYTE(end));
+        enc28j60_write_reg(EDMADSTL, LO_BYTE(dst));
+        enc28j60_write_reg(EDMADSTH, HI_BYTE(dst));
+
+        /* CSUMEN would make the DMA compute a checksum instead of copying */
+        enc28j60_bitclr_reg(ECON1, ECON1_CSUMEN);
+        enc28j60_bitset_reg(ECON1, ECON1_DMAST);
+        for (i = 0; i < 100; i++) {
+                if ((enc28j60_read_reg(ECON1) & ECON1_DMAST) == 0) {
+                        break;
+                }
+        }
+        if (i == 100) {
+                /* abort the copy, the Tx memory must not change under the MAC */
+                enc28j60_bitclr_reg(ECON1, ECON1_DMAST);
+                for (i = 0; i < 100; i++) {
+                        if ((enc28j60_read_reg(ECON1) & ECON1_DMAST) == 0) {
+                                break;
+                        }
+                }
+                enc28j60_bitset_reg(ECON1, ECON1_CSUMEN);
+                LOG_ERR("%s: DMA timed out!", __func__);
+                return FALSE;
+        }
+        enc28j60_bitset_reg(ECON1, ECON1_CSUMEN);
+
+        return TRUE;
+}
+
+
+
+/* Answers ARP requests and ICMP echo requests to FastRespIp from the header
+** prefix alone. An ARP reply fits in the prefix, hence it is written as a
+** whole. An echo reply is the request with the MACs, IPs, ICMP type and
+** checksum changed, so the request is DMA copied to the fast responder Tx
+** slot and only its first 38 bytes are re-written. Returns TRUE if the frame
+** is consumed. */
+static boolean enc28j60_fast_respond(const uint8 *pfx, uint16 frame_addr, uint16 pktlen) {
+        uint8 reply[1 + FR_HDR_SZ]; /* per-packet control byte + headers */
+        uint8 *rp = reply + 1;
+        uint16 txlen, csum;
+        boolean is_arp;
+
+        if ((FastRespEn == FALSE) || (pktlen < FR_HDR_SZ)) {
+                return FALSE;
+        }
+
+        /* ARP request (Eth, IPv4) for our IP */
+        is_arp = (pfx[12] == 0x08) && (pfx[13] == 0x06) && (pfx[14] == 0x00) && (pfx[15] == 0x01) &&
+                (pfx[16] == 0x08) && (pfx[17] == 0x00) && (pfx[18] == 6) && (pfx[19] == 4) &&
+                (pfx[20] == 0x00) && (pfx[21] == 0x01) && (memcmp(pfx+38, FastRespIp, 4) == 0);
+
+        /* ICMP echo request to our MAC & IP, no IP options, not fragmented */
+        if (!is_arp && !((pfx[12] == 0x08) && (pfx[13] == 0x00) && (pfx[14] == 0x45) &&
+                (pfx[23] == 1) && ((pfx[20] & 0x3F) == 0) && (pfx[21] == 0) &&
+                (memcmp(pfx+30, FastRespIp, 4) == 0) && (memcmp(pfx, MacAddr, 6) == 0) &&
+                (pfx[34] == 8) && (pfx[35] == 0))) {
+                return FALSE;
+        }
+
+        /* the echo reply must fit into the fast responder slot (with TSV),
+        else the request goes to the upper layers, never a truncated echo */
+        if (!is_arp && (1 + pktlen + TSV_SZ > FR_TX_SZ)) {
+                return FALSE;
+        }
+
+        /* the fast responder slot is the Tx memory in use, wait for the MAC */
+        if (FALSE == enc28j60_tx_idle()) {
+                FastRespStats.busy_fallbacks++;
+                return FALSE;
+        }
+
+        reply[0] = 0x00;
+        memcpy(rp, pfx, FR_HDR_SZ);
+        memcpy(rp, pfx+6, 6);           // Eth dst = requester
+        memcpy(rp+6, MacAddr, 6);       // Eth src = us
+        if (is_arp) {
+                rp[21] = 0x02;          // ARP reply
+                memcpy(rp+32, pfx+22, 10); // THA, TPA = SHA, SPA of request
+                memcpy(rp+22, MacAddr, 6);
+                memcpy(rp+28, FastRespIp, 4);
+                txlen = FR_HDR_SZ;
+                enc28j60_write_mem_at(FR_TX_BEG, reply, 1 + FR_HDR_SZ);
+                FastRespStats.arp_replies++;
+        }
+        else {
+                /* type 8 -> 0 adds 0x0800 to the checksum, the IP checksum
+                doesn't change by swapping the addresses */
+                memcpy(rp+26, pfx+30, 4);
+                memcpy(rp+30, pfx+26, 4);
+                rp[34] = 0;
+                csum = ((pfx[36] << 8) | pfx[37]) + 0x0800;
+                csum += (csum < 0x0800) ? 1 : 0; // end around carry
+                rp[36] = HI_BYTE(csum);
+                rp[37] = LO_BYTE(csum);
+                txlen = pktlen;
+                if (FALSE == enc28j60_dma_copy(frame_addr, pktlen, FR_TX_BEG+1)) {
+                        return FALSE;
+                }
+                enc28j60_write_mem_at(FR_TX_BEG, reply, 1 + 38);
+                FastRespStats.icmp_replies++;
+        }
+
+        enc28j60_tx_start(FR_TX_BEG, txlen);
+
+        return TRUE;
+}
+#endif
+
+
+
+#if ENC28J60_TX_STREAMS > 0
+/* Registers a cyclic Tx stream. The headers in cfg are written once into the
+** Tx memory slot of the stream, after the per-packet control byte. For IPv4
+** the header sum of the fields that do not change is kept, so that each
+** enc28j60_stream_send only writes the length, ID, checksum and payload.
+** Only for the owner context, as both do SPI accesses. */
+boolean enc28j60_stream_register(const enc28j60_stream_cfg_t *cfg, uint8 *id) {
+        enc28j60_stream_t *strm = NULL;
+        uint8 *hdr = SpiEthBasicTx+2; // +2 for WR_MEM_OPCODE and control byte
+        uint16 ihl, i;
+        uint8 s;
+
+        if (FALSE == macphy_txq_is_owner()) {
+                LOG_ERR("%s: not called from the owner context!", __func__);
+                return FALSE;
+        }
+
+        if ((cfg == NULL) || (id == NULL) || (cfg->hdr == NULL) ||
+                (cfg->hdr_len < 14) || (cfg->hdr_len+2 > ENC28J60_BASIC_MSG_LEN)) {
+                LOG_ERR("%s: invalid stream headers!", __func__);
+                return FALSE;
+        }
+
+        /* IPv4 (if any) must be within the headers, UDP (if any) must end
+        them as enc28j60_stream_send writes the payload right after it */
+        ihl = (cfg->ip_ofs) ? ((cfg->hdr[cfg->ip_ofs] & 0x0F) * 4) : 0;
+        if ((cfg->ip_ofs && ((ihl < 20) || (cfg->ip_ofs + ihl > cfg->hdr_len))) ||
+                (cfg->udp_ofs && ((cfg->ip_ofs == 0) || (cfg->udp_ofs < cfg->ip_ofs + ihl) ||
+                (cfg->udp_ofs + 8 != cfg->hdr_len)))) {
+                LOG_ERR("%s: invalid IPv4 / UDP offsets!", __func__);
+                return FALSE;
+        }
+
+        for (s = 0; s < ENC28J60_TX_STREAMS; s++) {
+                if (TxStreams[s].used == FALSE) {
+                        strm = &TxStreams[s];
+                        break;
+                }
+        }
+        if (strm == NULL) {
+                LOG_ERR("%s: no free stream, increase ENC28J60_TX_STREAMS!", __func__);
+                return FALSE;
+        }
+
+        strm->hdr_len = cfg->hdr_len;
+        strm->ip_ofs = cfg->ip_ofs;
+        strm->udp_ofs = cfg->udp_ofs;
+        strm->ip_id = 0;
+        strm->ip_sum = 0;
+        for (i = 0; i < ihl; i += 2) {
+                if ((i != 2) && (i != 4) && (i != 10)) {
+                        strm->ip_sum += (cfg->hdr[cfg->ip_ofs+i] << 8) | cfg->hdr[cfg->ip_ofs+i+1];
+                }
+        }
+
+        /* the control byte and headers stay in the slot */
+        SpiEthBasicTx[1] = 0x00;
+        memcpy(hdr, cfg->hdr, cfg->hdr_len);
+        if (FALSE == enc28j60_write_mem_buf(STRM_TX_BEG + s * STRM_SLOT_SZ, SpiEthBasicTx,
+                SpiEthBasicRx, 1 + cfg->hdr_len)) {
+                return FALSE;
+        }
+
+        strm->used = TRUE;
+        *id = s;
+
+        return TRUE;
+}
+
+
+
+void enc28j60_stream_unregister(uint8 id) {
+        if (id < ENC28J60_TX_STREAMS) {
+                TxStreams[id].used = FALSE;
+        }
+}
+
+
+
+/* Sends a frame of a registered stream. Only the IPv4 total length, ID and
+** checksum, the UDP length and checksum (sent as 0) and the payload go over
+** SPI. Returns FALSE if the MAC is busy, the caller shall retry later. Note:
+** stream frames do not wait behind the frames in the Tx FIFO. */
+boolean enc28j60_stream_send(uint8 id, const uint8 *payload, uint16 plen) {
+        enc28j60_stream_t *strm;
+        spi_mpool_t *mpool;
+        uint8 ipf[10]; /* total length .. checksum of the IPv4 header */
+        uint16 slot, ofs, len;
+        uint32 sum;
+        uint8 *p;
+
+        if ((id >= ENC28J60_TX_STREAMS) || (TxStreams[id].used == FALSE) ||
+                ((payload == NULL) && (plen > 0))) {
+                return FALSE;
+        }
+        if (FALSE == macphy_txq_is_owner()) {
+                LOG_ERR("%s: not called from the owner context!", __func__);
+                return FALSE;
+        }
+        strm = &TxStreams[id];
+        slot = STRM_TX_BEG + id * STRM_SLOT_SZ;
+        if (1 + strm->hdr_len + plen + TSV_SZ > STRM_SLOT_SZ) {
+                LOG_ERR("%s: payload of %d bytes too big for the stream slot!", __func__, plen);
+                return FALSE;
+        }
+
+        if (((MacPhy_state & MACPHY_LINK_UP) == 0) || (FALSE == enc28j60_tx_idle())) {
+                return FALSE;
+        }
+
+        /* IPv4 length, ID and header checksum */
+        if (strm->ip_ofs) {
+                len = strm->hdr_len - strm->ip_ofs + plen;
+                sum = strm->ip_sum + len + strm->ip_id;
+                while (sum >> 16) {
+                        sum = (sum & 0xFFFF) + (sum >> 16);
+                }
+                sum = ~sum & 0xFFFF;
+                ipf[0] = HI_BYTE(len);
+                ipf[1] = LO_BYTE(len);
+                ipf[2] = HI_BYTE(strm->ip_id);
+                ipf[3] = LO_BYTE(strm->ip_id);
+                strm->ip_id++;
+
+                /* flags, TTL and protocol in between are left as they are */
+                ofs = slot + 1 + strm->ip_ofs + 2;
+                enc28j60_write_mem_at(ofs, ipf, 4);
+                ipf[0] = HI_BYTE(sum);
+                ipf[1] = LO_BYTE(sum);
+                enc28j60_write_mem_at(ofs + 8, ipf, 2);
+        }
+
+        /* UDP length and checksum, followed by the payload */
+        ofs = strm->udp_ofs ? (strm->udp_ofs + 4) : strm->hdr_len;
+        len = strm->hdr_len - ofs + plen;
+        if (len > 0) {
+                mpool = get_new_spi_mpool_tx();
+                if (mpool == NULL) {
+                        return FALSE;
+                }
+                p = mpool->tx_buf+1; // +1 for WR_MEM_OPCODE
+                if (strm->udp_ofs) {
+                        *p++ = HI_BYTE(strm->hdr_len - strm->udp_ofs + plen);
+                        *p++ = LO_BYTE(strm->hdr_len - strm->udp_ofs + plen);
+                        *p++ = 0x00; // checksum is optional in IPv4
+                        *p++ = 0x00;
+                }
+                memcpy(p, payload, plen);
+                enc28j60_write_mem_buf(slot + 1 + ofs, mpool->tx_buf, mpool->rx_buf, len);
+                free_spi_mpool(mpool);
+        }
+
+        enc28j60_tx_start(slot, strm->hdr_len + plen);
+
+        return TRUE;
+}
+#endif
+
+
+
+#if ENC28J60_TX_GATHER == 1
+/* WBM of data at EWRPT, the opcode and the data go on separate channels of
+** one job, so the data needs no room for the opcode in front of it */
+static boolean enc28j60_write_mem_frag(const uint8 *data, uint16 len) {
+        SpiEthBasicTx[0] = (uint8) (WR_MEM_OPCODE);
+        Spi_SetupEB(0, SpiEthBasicTx, SpiEthBasicRx, 1);
+        Spi_SetupEB(1, data, NULL, len);
+        if (E_NOT_OK == enc28j60_spi_xfer_seq(SEQ_ETHERNET_WBM_SG, SPI_CAT_WBM_PAYLOAD, len+1, len)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+#endif
+
+
+
+/* Takes the ingress timestamp of the oldest frame in the Rx buffer, at the
+** tightest point the driver sees: the INT of a lone frame, else the EPKTCNT
+** read that saw it first. A frame that was already waiting behind others at
+** the last read came after the last read that left no older frame. obs is the
+** cycles just before the EPKTCNT read. */
+static void enc28j60_rx_stamp(uint32 obs, uint8 pktcnt) {
+        if (pktcnt == 0) {
+                RxTsEmpty = obs;
+        }
+        else if ((RxPktsPending == 0) && (pktcnt == 1) && RxIrqStamp &&
+                 ((sint32)(RxIrqStamp - RxTsObs) > 0)) {
+                /* the interrupt latency is not known, taken as 0 */
+                RxTs.cyc = RxIrqStamp;
+                RxTs.err_cyc = 0;
+                RxTs.valid = TRUE;
+        }
+        else if (RxPktsPending == 0) {
+                macphy_ts_capture(&RxTs, RxTsObs, 0);
+        }
+        else {
+                RxTs.cyc = RxTsObs;
+                RxTs.err_cyc = RxTsObs - RxTsEmpty;
+                RxTs.valid = TRUE;
+        }
+
+        if (pktcnt == 1) {
+                RxTsEmpty = obs;
+        }
+        RxTsObs = obs;
+}
+
+
+
+/* Switches the Rx between interrupt and polling mode, called with the
+** EPKTCNT of each receive attempt */
+static void enc28j60_rx_mode_service(uint8 pktcnt) {
+        uint32 lat;
+
+        /* latency from the interrupt to the frame being read */
+        if (RxIrqStamp && pktcnt) {
+                lat = k_cyc_to_us_floor32(k_cycle_get_32() - RxIrqStamp);
+                RxIrqStamp = 0;
+                RxMode.lat_sum_us += lat;
+                RxMode.lat_cnt++;
+                if (lat > RxMode.lat_max_us) {
+                        RxMode.lat_max_us = lat;
+                }
+        }
+
+        if (RxMode.polling == FALSE) {
+                if (pktcnt == 0) {
+                        return;
+                }
+                RxMode.irq_frames++;
+                if ((pktcnt >= RxMode.coal_frames) || RxIrqBurst) {
+                        enc28j60_bitclr_reg(EIE, EIE_PKTIE);
+                        RxMode.polling = TRUE;
+                        RxMode.to_poll++;
+                        RxPollCnt = 0;
+                }
+                RxIrqBurst = FALSE;
+                return;
+        }
+
+        if (pktcnt) {
+                RxMode.poll_frames++;
+                RxPollCnt++;
+        }
+        if ((pktcnt == 0) || (RxPollCnt >= RxMode.poll_budget)) {
+                enc28j60_bitset_reg(EIE, EIE_PKTIE);
+                RxMode.polling = FALSE;
+                RxMode.to_irq++;
+        }
+}
+
+
+
 //////////////////////////////////////////////
 // Global Functions
-boolean macphy_pkt_send(uint8 *pktptr, uint16 pktlen) {
+boolean enc28j60_pkt_send(uint8 *pktptr, uint16 pktlen) {
         spi_mpool_t *mpool;
-        uint16 i;
-        uint8 regbits;
-        boolean tx_abort;
 
-        if (pktptr == NULL) {
+        if ((pktptr == NULL) || (pktlen+MEM_POOL_TX_DATA_OFS > MAX_ETH_FRAME_LEN)) {
                 return FALSE;
         }
 
-        /* get memory pool for ethernet frame transfer */
-        mpool = get_new_spi_mpool();
+        /* get memory pool for ethernet frame transfer, no pool = no Tx credit */
+        mpool = get_new_spi_mpool_tx();
         if (mpool == NULL) {
-                LOG_ERR("Can't send the pkt(len = %d), no free mpool!", pktlen);
+                TxErrCounters.TxDroppedNoErrorPkts++;
                 return FALSE;
         }
 
-        /* check if any transmit errors from previous attempt */
-        regbits = enc28j60_read_reg(ESTAT);
-        tx_abort = regbits & ESTAT_TXABRT;
-        if (tx_abort) {
-                enc28j60_bitclr_reg(ECON1, ECON1_TXRTS);
+        MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+        memcpy(mpool->tx_buf+MEM_POOL_TX_DATA_OFS, pktptr, pktlen);
+        mpool->dlen = pktlen;
+
+        return enc28j60_mpool_send(mpool);
+}
+
+
+
+/* Streams the fragments into the Tx memory one after the other, EWRPT moves
+** on by itself, and sends the frame. Only done while the MAC and the Tx FIFO
+** are idle, so that the frame doesn't overtake the queued ones; FALSE lets
+** macphy_frags_send queue a flattened copy instead. */
+boolean enc28j60_frags_send(const macphy_frag_t *frags, uint8 nfrags) {
+#if ENC28J60_TX_GATHER == 1
+        uint16 len = 0;
+        uint8 ctrl = 0x00; // per-packet control byte
+        uint8 i;
+
+        for (i = 0; i < nfrags; i++) {
+                len += frags[i].len;
+        }
+        if ((1 + len + TSV_SZ > FR_TX_BEG - TX_BUF_BEG) || (get_spi_mpool_tx_queued() > 0) ||
+                ((MacPhy_state & MACPHY_LINK_UP) == 0) || (FALSE == enc28j60_tx_idle())) {
+                return FALSE;
         }
 
-        /* Setup / copy data to Tx Buffer to mpool */
-        mpool->tx_buf[0] = (uint8)(WR_MEM_OPCODE);
-        mpool->tx_buf[1] = (uint8)(0x00); // per-packet control byte, refer section 7.1 of ENC28J60 manual
-        for (i = 0; i < pktlen; i++) {
-                mpool->tx_buf[i+2] = pktptr[i];
+        MACPHY_TRACE(TRC_TX_SPI_WR_START, 0);
+        enc28j60_write_mem_at(TX_BUF_BEG, &ctrl, 1);
+        for (i = 0; i < nfrags; i++) {
+                if ((frags[i].len > 0) && (FALSE == enc28j60_write_mem_frag(frags[i].data, frags[i].len))) {
+                        return FALSE;
+                }
         }
-        mpool->dlen = pktlen;
-        mpool->state = MPOOL_DATA_FILLED;
+        MACPHY_TRACE(TRC_TX_SPI_WR_DONE, 0);
+        enc28j60_tx_start(TX_BUF_BEG, len);
+
+        return TRUE;
+#else
+        (void) frags;
+        (void) nfrags;
+        return FALSE;
+#endif
+}
+
+
+
+/* Queues a frame that is already in a Tx pool (from get_new_spi_mpool_tx) at
+** tx_buf+MEM_POOL_TX_DATA_OFS. Frames are sent in the order they are queued. */
+boolean enc28j60_mpool_send(spi_mpool_t *mpool) {
+        uint8 regbits;
 
-        /* check if the MACPHY is busy as well as see if link is up */
-        regbits = enc28j60_read_reg(ECON1);
-        if ((regbits & ECON1_TXRTS) || ((MacPhy_state & MACPHY_LINK_UP) == 0)) {
-                /* if the link is down, read it now for future use */
-                read_enc28j60_phstat_regs();
+        if (mpool == NULL) {
+                return FALSE;
+        }
 
-                /* the pkt will be sent later from macphy_periodic_fn */
+        /* check if any transmit errors from previous attempt */
+        regbits = enc28j60_read_reg(ESTAT);
+        if (regbits & ESTAT_TXABRT) {
+                enc28j60_retry_aborted_tx();
         }
-        else {
-                /* NOT BUSY - send data to MACPHY via mem-pool */
-                send_pkt_from_mpool(mpool);
+
+        /* Setup the SPI opcode and per-packet control byte, refer section 7.1 of ENC28J60 manual */
+        mpool->tx_buf[0] = (uint8)(WR_MEM_OPCODE);
+        mpool->tx_buf[1] = (uint8)(0x00);
+
+        /* queue it behind the earlier frames, then send the oldest if the
+        MACPHY is free, else the pkt will be sent later from enc28j60_periodic_fn */
+        if (FALSE == put_spi_mpool_w_data(mpool)) {
+                free_spi_mpool(mpool);
+                TxErrCounters.TxDroppedNoErrorPkts++;
+                return FALSE;
         }
+        enc28j60_tx_fifo_kick();
 
 #if ADDL_ENC28J60_ERROR_CHECKS == 1
         /* check for errors while sending */
         if (enc28j60_read_reg(ESTAT) & ESTAT_TXABRT)
         {
-                // a seven-byte transmit status vector will be
-                // written to the location pointed to by ETXND + 1,
+                // the TSV at ETXND + 1 is decoded on the next Tx
                 LOG_ERR("ERR - transmit aborted");
         }
 
@@ -520,20 +1941,49 @@ boolean macphy_pkt_send(uint8 *pktptr, uint16 pktlen) {
 
 
 
+/* A failed SPI read of a frame leaves it in the MACPHY: ERXRDPT and PKTDEC
+** are not touched, so that the next call reads it again from its header */
+static uint16 enc28j60_rx_abort(spi_mpool_t *mpool, uint8 pktcnt) {
+        RxPktsPending = pktcnt;
+        if (FALSE == free_spi_mpool(mpool)) {
+                LOG_ERR("%s(): Unable to free mpool", __func__);
+        }
+
+        return 0;
+}
+
+
+
 #define RX_PKT_HDR_SZ (6) /* 2 byte next pkt pointer + rx status vector */
-uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+uint16 enc28j60_pkt_recv(uint8 *pktptr, uint16 maxlen) {
         spi_mpool_t *mpool;
         uint8 *rx_pkt_hdr;
-        uint16 pktlen;
+        uint16 pktlen, pfxlen = 0;
+        uint16 framelen; // length without CRC, before the limit to maxlen
+        uint16 rest = 0; // frame bytes to read after the prefix
+        macphy_rx_verdict_t verdict;
+        uint16 frame_addr;
         static uint16 nxtpktptr = RX_BUF_BEG;
         static uint16 rx_status;
         uint8 pktcnt;
+        uint32 obs;
 
         /* check if any pkts are there in external MACPHY recev. buffer */
+        obs = k_cycle_get_32();
         pktcnt = enc28j60_read_reg(EPKTCNT);
+        enc28j60_rx_stamp(obs, pktcnt);
+        enc28j60_rx_mode_service(pktcnt);
+        if ((pktcnt > 0) && (pktcnt >= Telemetry.pktcnt_hwm)) {
+                Telemetry.pktcnt_hwm = pktcnt;
+                Telemetry.pktcnt_hwm_ms = k_uptime_get_32();
+        }
         if (pktcnt == 0) {
+                RxPktsPending = 0;
+                enc28j60_rx_flow_service();
                 return 0;
         }
+        RxPktsPending = pktcnt - 1;
+        MACPHY_TRACE(TRC_RX_PKTCNT_SEEN, RxFrameSeq);
 
 
         /* get memory pool for ethernet frame reception */
@@ -543,14 +1993,27 @@ uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
                 return 0;
         }
 
+        /* read next pkt pointer and rx status vector, along with the header
+        prefix of the frame for the classifier and the fast responder */
+        rx_pkt_hdr = mpool->rx_buf+1; // +1 for WR_MEM_OPCODE
+        mpool->dlen = RX_PKT_HDR_SZ + RX_PREFIX_SZ;
+#if ENC28J60_SPI_CHAINED == 1
+        if (FALSE == enc28j60_rx_head_chained(mpool, nxtpktptr)) {
+                return enc28j60_rx_abort(mpool, pktcnt);
+        }
+#else
         /* set the read pointer to the start of the next packet */
         enc28j60_write_reg(ERDPTL, LO_BYTE(nxtpktptr));
         enc28j60_write_reg(ERDPTH, HI_BYTE(nxtpktptr));
-
-        /* read next pkt pointer and rx status vector */
-        rx_pkt_hdr = mpool->rx_buf+1; // +1 for WR_MEM_OPCODE
-        mpool->dlen = RX_PKT_HDR_SZ;
-        enc28j60_read_mem(mpool);
+        if (FALSE == enc28j60_read_mem(mpool, SPI_CAT_RBM_STATUS)) {
+                return enc28j60_rx_abort(mpool, pktcnt);
+        }
+#endif
+        MACPHY_TRACE(TRC_RX_HDR_READ, RxFrameSeq);
+        frame_addr = nxtpktptr + RX_PKT_HDR_SZ;
+        if (frame_addr > RX_BUF_END) {
+                frame_addr -= RX_BUF_SZ;
+        }
 
         /* as per figure 7-3 of datasheet (page - 45), read next pkt pointer */
         nxtpktptr = rx_pkt_hdr[0]; // low byte
@@ -559,7 +2022,9 @@ uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
         /* read length (incl. crc + padding) as per table 7-3 (page - 46) */
         pktlen = rx_pkt_hdr[2];
         pktlen |= rx_pkt_hdr[3] << 8;
+        RxTs.ofs_ns = pktlen * ENC28J60_NS_PER_BYTE; // SFD to the end of the frame
         pktlen -= 4; // CRC len, macphy will verify CRC
+        framelen = pktlen;
 
         /* limit the upcoming read size based on client memory size */
         if (pktlen > maxlen) {
@@ -571,17 +2036,67 @@ uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
         rx_status |= (rx_pkt_hdr[5] << 8);
 
         /* copy the new message from ENCJ60 hardware to mpool, if ok */
+#if ENC28J60_FAST_RESPONDER == 1
+        if ((rx_status & 0x80) && enc28j60_fast_respond(rx_pkt_hdr+RX_PKT_HDR_SZ, frame_addr, framelen)) {
+                pktlen = 0; // answered by the MACPHY, nothing for the upper layers
+        }
+        else
+#endif
         if (rx_status & 0x80) {
-                mpool->dlen = pktlen;
-                enc28j60_read_mem(mpool);
+                /* the prefix is read already, the classifier decides on the rest */
+                pfxlen = (pktlen < RX_PREFIX_SZ) ? pktlen : RX_PREFIX_SZ;
+                verdict = MACPHY_RX_FULL;
+                if (RxClassifier) {
+                        verdict = RxClassifier(rx_pkt_hdr+RX_PKT_HDR_SZ, pfxlen, pktlen);
+                }
+
+                if (verdict == MACPHY_RX_DROP) {
+                        RxClassStats.dropped++;
+                        RxClassStats.bytes_saved += pktlen - pfxlen;
+                        pfxlen = pktlen = 0;
+                }
+                else if (verdict == MACPHY_RX_HDR_ONLY) {
+                        RxClassStats.hdr_only++;
+                        RxClassStats.bytes_saved += pktlen - pfxlen;
+                        pktlen = pfxlen;
+                }
+                memcpy(pktptr, rx_pkt_hdr+RX_PKT_HDR_SZ, pfxlen);
+                rest = pktlen - pfxlen;
+#if ENC28J60_SPI_CHAINED == 0
+                if (rest > 0) {
+                        mpool->dlen = rest;
+                        if (FALSE == enc28j60_read_mem(mpool, SPI_CAT_RBM_PAYLOAD)) {
+                                nxtpktptr = RxRdPtr; // start of this frame
+                                return enc28j60_rx_abort(mpool, pktcnt);
+                        }
 
-                /* TODO: revisit this data copy design (+1 for WR_MEM_OPCODE) */
-                memcpy(pktptr, mpool->rx_buf+1, pktlen);
+                        /* TODO: revisit this data copy design (+1 for WR_MEM_OPCODE) */
+                        memcpy(pktptr+pfxlen, mpool->rx_buf+1, rest);
+                }
+                MACPHY_TRACE(TRC_RX_PAYLOAD_READ, RxFrameSeq);
+#endif
         }
         else {
                 pktlen = 0; // Rx error present, hence ignore the packet
         }
 
+#if ENC28J60_SPI_CHAINED == 1
+        /* rest of the pkt, ERXRDPT and PKTDEC as one SPI sequence. It is not
+        repeated on a failure, as PKTDEC may have gone already, the frame is
+        dropped instead */
+        if (FALSE == enc28j60_rx_tail_chained(mpool, rest, nxtpktptr)) {
+                rest = pktlen = 0;
+        }
+        if (rest > 0) {
+                memcpy(pktptr+pfxlen, mpool->rx_buf+1, rest);
+                MACPHY_TRACE(TRC_RX_PAYLOAD_READ, RxFrameSeq);
+        }
+        RxRdPtr = nxtpktptr;
+
+        if (FALSE == free_spi_mpool(mpool)) {
+                LOG_ERR("%s(): Unable to free mpool", __func__);
+        }
+#else
         /* free the memory pool */
         if (FALSE == free_spi_mpool(mpool)) {
                 LOG_ERR("%s(): Unable to free mpool", __func__);
@@ -590,48 +2105,316 @@ uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
         /* move Rx read pointer to nxtpktptr to free up buffer space in HW */
         enc28j60_write_reg(ERXRDPTL, LO_BYTE(nxtpktptr));
         enc28j60_write_reg(ERXRDPTH, HI_BYTE(nxtpktptr));
-        LOG_DBG("rx_status = 0x%04x, next_pkt_ptr = 0x%04x", rx_status, nxtpktptr);
+        RxRdPtr = nxtpktptr;
 
         /* inform HW that we are done with the reading of current packet */
         enc28j60_bitset_reg(ECON2, ECON2_PKTDEC);
+#endif
+#if ADDL_ENC28J60_DEBUG_PRINTS == 1
+        LOG_DBG("rx_status = 0x%04x, next_pkt_ptr = 0x%04x", rx_status, nxtpktptr);
+#endif
+        MACPHY_TRACE(TRC_RX_DELIVERED, RxFrameSeq);
+        RxFrameSeq++;
+
+        /* pause the link partner if the host can't keep up */
+        enc28j60_rx_flow_service();
 
         return pktlen;
 }
 
 
 
-void macphy_periodic_fn(void) {
-        spi_mpool_t *mpool;
+void enc28j60_periodic_fn(void) {
         uint8 regbits;
 
-        /* check if the MACPHY is busy as well as see if link is up */
-        regbits = enc28j60_read_reg(ECON1);
-        if ((regbits & ECON1_TXRTS) || ((MacPhy_state & MACPHY_LINK_UP) == 0)) {
-                /* if the link is down, read it now for future use */
-                read_enc28j60_phstat_regs();
-                return;
+        /* one EIR read per call, for the link change and the Rx overflow */
+        regbits = enc28j60_read_reg(EIR);
+
+        /* serve the PHY accesses, update the link state if it has changed */
+        enc28j60_link_service(regbits);
+
+        /* count the frames lost due to Rx buffer overflow */
+        if (regbits & EIR_RXERIF) {
+                enc28j60_bitclr_reg(EIR, EIR_RXERIF);
+                RxFlow.overflows++;
+                Telemetry.rx_overflows++;
+                Telemetry.rx_overflow_ms = k_uptime_get_32();
         }
 
-        /* loop through the mem_pool for sending prefilled pkt */
-        do {
-                /* get filled memory pool for ethernet transmission */
-                mpool = get_spi_mpool_w_data();
+        /* re-transmit the last frame if it was aborted */
+        regbits = enc28j60_read_reg(ESTAT);
+        if (regbits & ESTAT_BUFER) {
+                enc28j60_bitclr_reg(ESTAT, ESTAT_BUFER);
+                Telemetry.buf_errors++;
+                Telemetry.buf_error_ms = k_uptime_get_32();
+        }
+        if (regbits & ESTAT_TXABRT) {
+                enc28j60_retry_aborted_tx();
+        }
 
-                if(mpool) {
-                        send_pkt_from_mpool(mpool);
-                        if (FALSE == free_spi_mpool(mpool)) {
-                                LOG_ERR("%s(): Unable to free mpool", __func__);
-                        }
+        /* send the oldest pending frame */
+        enc28j60_tx_fifo_kick();
+}
+
+
+
+void enc28j60_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs) {
+        if (cntrs != NULL) {
+                *cntrs = TxErrCounters;
+        }
+}
+
+
+
+void enc28j60_set_rx_classifier(macphy_rx_classify_t fn) {
+        RxClassifier = fn;
+}
+
+
+
+void enc28j60_get_rx_class_stats(enc28j60_rx_class_stats_t *stats) {
+        if (stats != NULL) {
+                *stats = RxClassStats;
+        }
+}
+
+
+
+#if ENC28J60_FAST_RESPONDER == 1
+/* Sets the IPv4 address the fast responder answers for, NULL turns it off */
+void enc28j60_set_fast_resp_ip(const uint8 *ip_addr) {
+        FastRespEn = FALSE;
+        if (ip_addr != NULL) {
+                memcpy(FastRespIp, ip_addr, sizeof(FastRespIp));
+                FastRespEn = TRUE;
+        }
+}
+
+
+
+void enc28j60_get_fast_resp_stats(enc28j60_fast_resp_stats_t *stats) {
+        if (stats != NULL) {
+                *stats = FastRespStats;
+        }
+}
+#endif
+
+
+
+void enc28j60_get_rx_flow_info(enc28j60_rx_flow_t *info) {
+        if (info != NULL) {
+                *info = RxFlow;
+        }
+}
+
+
+
+/* Sets the Rx buffer fill levels (in bytes) at which the PAUSE frames are
+** started and stopped. hi_mark must be above lo_mark. */
+boolean enc28j60_set_rx_watermarks(uint16 hi_mark, uint16 lo_mark) {
+        if ((hi_mark <= lo_mark) || (hi_mark >= RX_BUF_SZ)) {
+                return FALSE;
+        }
+
+        RxFlow.hi_mark = hi_mark;
+        RxFlow.lo_mark = lo_mark;
+        return TRUE;
+}
+
+
+
+/* ingress timestamp of the frame returned by the last enc28j60_pkt_recv */
+boolean enc28j60_get_rx_ts(macphy_ts_t *ts) {
+        if ((ts == NULL) || (RxTs.valid == FALSE)) {
+                return FALSE;
+        }
+        *ts = RxTs;
+
+        return TRUE;
+}
+
+
+
+/* starts the frames of the Tx FIFO while the MAC is free. An aborted frame
+** is still in the Tx buffer, it is re-transmitted before the next overwrites it */
+void enc28j60_tx_service(void) {
+        if (enc28j60_read_reg(ESTAT) & ESTAT_TXABRT) {
+                enc28j60_retry_aborted_tx();
+        }
+        enc28j60_tx_fifo_kick();
+}
+
+
+
+/* number of received frames that were left in the MACPHY by enc28j60_pkt_recv */
+uint8 enc28j60_rx_pending(void) {
+        return RxPktsPending;
+}
+
+
+
+/* Called from the ISR of the INT pin, no SPI access here */
+void enc28j60_irq_notify(void) {
+        uint32 now = k_cycle_get_32();
+
+        RxMode.irqs++;
+        if (k_cyc_to_us_floor32(now - RxIrqLast) < RxMode.coal_usec) {
+                RxIrqBurst = TRUE;
+        }
+        RxIrqLast = now;
+        if (RxIrqStamp == 0) {
+                RxIrqStamp = now | 1; // never 0
+        }
+}
+
+
+
+/* TRUE while the Rx is in polling mode, the owner shall not wait for the INT */
+boolean enc28j60_rx_polling(void) {
+        return RxMode.polling;
+}
+
+
+
+void enc28j60_set_rx_coalescing(uint8 frames, uint16 usec, uint16 poll_budget) {
+        RxMode.coal_frames = (frames > 0) ? frames : 1;
+        RxMode.coal_usec = usec;
+        RxMode.poll_budget = (poll_budget > 0) ? poll_budget : 1;
+}
+
+
+
+void enc28j60_get_rx_mode_info(enc28j60_rx_mode_t *info) {
+        if (info != NULL) {
+                *info = RxMode;
+        }
+}
+
+
+
+/* number of frames that can be given to enc28j60_pkt_send without a drop */
+uint8 enc28j60_tx_credit(void) {
+        return (uint8) get_spi_mpool_tx_credit();
+}
+
+
+
+void enc28j60_get_link_info(enc28j60_link_info_t *info) {
+        if (info != NULL) {
+                *info = LinkInfo;
+        }
+}
+
+
+
+void enc28j60_get_telemetry(enc28j60_telemetry_t *tlm) {
+        if (tlm != NULL) {
+                *tlm = Telemetry;
+                /* include the wait that is still going on */
+                if (LinkDownPendStart != 0) {
+                        tlm->link_down_pending_ms += k_uptime_get_32() - LinkDownPendStart;
                 }
-        } while (mpool);
+        }
+}
+
+
+
+/* Clears the high-water marks and the event counters. A link wait that is
+** going on is counted from now on. */
+void enc28j60_reset_telemetry(void) {
+        uint32 now = k_uptime_get_32();
+
+        memset(&Telemetry, 0, sizeof(Telemetry));
+        if (LinkDownPendStart != 0) {
+                LinkDownPendStart = now ? now : 1;
+                Telemetry.link_down_pending = 1;
+                Telemetry.link_down_last_ms = LinkDownPendStart;
+        }
+}
+
+
+
+/* Sets the max. frame bytes per RBM / WBM (0 = not split) and the Tx FIFO
+** prio from which frames may go ahead of a chunked Rx read. The chunk must
+** be long enough for the SPI overhead to stay low. */
+boolean enc28j60_set_spi_chunking(uint16 chunk_len, uint8 express_prio) {
+        if ((chunk_len > 0) && (chunk_len < 16)) {
+                return FALSE;
+        }
+
+        SpiArb.chunk_len = chunk_len;
+        SpiArb.express_prio = express_prio;
+        return TRUE;
+}
+
+
+
+/* Sets the hook called between the chunks, e.g., to run the SPI jobs of the
+** other devices on the bus. It must not call into this driver. */
+void enc28j60_set_spi_arbiter(enc28j60_spi_arb_cbk_t cbk) {
+        SpiArbCbk = cbk;
+}
+
 
+
+void enc28j60_get_spi_arb_info(enc28j60_spi_arb_t *info) {
+        if (info != NULL) {
+                *info = SpiArb;
+                info->max_block_us = k_cyc_to_us_ceil32(SpiMaxBlockCyc);
+                info->max_block_len = SpiMaxBlockLen;
+        }
 }
 
 
 
-boolean macphy_init(const uint8 *mac_addr) {
+void enc28j60_reset_spi_block_time(void) {
+        SpiMaxBlockCyc = 0;
+        SpiMaxBlockLen = 0;
+}
+
+
+
+void enc28j60_get_spi_prof(enc28j60_spi_prof_t *prof) {
+        if (prof == NULL) {
+                return;
+        }
+#if ENC28J60_SPI_PROFILING == 1
+        *prof = SpiProf;
+#else
+        memset(prof, 0, sizeof(enc28j60_spi_prof_t));
+#endif
+}
+
+
+
+void enc28j60_reset_spi_prof(void) {
+#if ENC28J60_SPI_PROFILING == 1
+        memset(&SpiProf, 0, sizeof(SpiProf));
+#endif
+}
+
+
+
+/* returns the SPI efficiency (payload bytes / total SPI bytes) in per mille */
+uint16 enc28j60_spi_efficiency(void) {
+        uint16 ratio = 0;
+
+#if ENC28J60_SPI_PROFILING == 1
+        if (SpiProf.total_bytes) {
+                ratio = (uint16)(((uint64)SpiProf.payload_bytes * 1000) / SpiProf.total_bytes);
+        }
+#endif
+
+        return ratio;
+}
+
+
+
+boolean enc28j60_init(const Eth_ConfigType *cfg) {
+        const uint8 *mac_addr;
         uint16 reg_bits;
 
+        mac_addr = (cfg != NULL) ? cfg->ctrlcfg.mac_addres : NULL;
         if (mac_addr == NULL) {
                 LOG_ERR("%s: invalid MAC address!", __func__);
                 return FALSE;
@@ -641,7 +2424,6 @@ boolean macphy_init(const uint8 *mac_addr) {
         enc28j60_sys_cmd(SC_RST_OPCODE);
 
         enc28j60_bitclr_reg(ECON1, 0x03);
-        LOG_DBG("This build uses MACPHY: ENC28J60");
 
         /* read the chip revision IDs */
         MAC_RevId = enc28j60_read_reg(EREVID);
@@ -654,6 +2436,7 @@ boolean macphy_init(const uint8 *mac_addr) {
         enc28j60_write_reg(ERXNDH, HI_BYTE(RX_BUF_END));
         enc28j60_write_reg(ERXRDPTL, LO_BYTE(RX_BUF_END));
         enc28j60_write_reg(ERXRDPTH, HI_BYTE(RX_BUF_END));
+        RxRdPtr = RX_BUF_BEG; // start of the unread data, for the fill
 
         /* set buffer memory layout - Tx */
         enc28j60_write_reg(ETXSTL, LO_BYTE(TX_BUF_BEG));
@@ -666,6 +2449,12 @@ boolean macphy_init(const uint8 *mac_addr) {
         /* set packet filter for reception */
         enc28j60_write_reg(ERXFCON, ERXFCON_UCEN | ERXFCON_CRCEN | ERXFCON_BCEN);
 
+        /* flow control: PAUSE time, PAUSE frames are sent on Rx buffer fill */
+        enc28j60_write_reg(EPAUSL, LO_BYTE(ENC28J60_PAUSE_QUANTA));
+        enc28j60_write_reg(EPAUSH, HI_BYTE(ENC28J60_PAUSE_QUANTA));
+        enc28j60_write_reg(EFLOCON, EFLOCON_FC_OFF);
+        RxFlow.paused = FALSE;
+
         /* MAC configurations */
         enc28j60_write_reg(MACON1, MACON1_MARXEN | MACON1_TXPAUS | MACON1_RXPAUS);
         enc28j60_write_reg(MACON2, 0x00);
@@ -693,6 +2482,7 @@ boolean macphy_init(const uint8 *mac_addr) {
         enc28j60_write_reg(MAADR2, mac_addr[3]);
         enc28j60_write_reg(MAADR1, mac_addr[4]);
         enc28j60_write_reg(MAADR0, mac_addr[5]);
+        memcpy(MacAddr, mac_addr, sizeof(MacAddr));
 
         /* Configure PHY */
         //----------------
@@ -715,11 +2505,37 @@ boolean macphy_init(const uint8 *mac_addr) {
         enc28j60_write_phy(PHLCON, 0x047A);
         enc28j60_write_phy(PHCON2, 0); // normal operation. To debug set PHCON2_FRCLNK and check
 
+        /* Enable link change interrupts and read the initial link state */
+        enc28j60_write_phy(PHIE, PHIE_PGEIE | PHIE_PLNKIE);
+        enc28j60_read_phy(PHIR);
+        read_enc28j60_phstat_regs();
+
         /* Enable packet receiption */
-        enc28j60_bitset_reg(EIE, EIE_INTIE | EIE_PKTIE);
+        enc28j60_bitset_reg(EIE, EIE_INTIE | EIE_PKTIE | EIE_LINKIE);
         enc28j60_bitset_reg(ECON1, ECON1_RXEN | ECON1_CSUMEN);
 
         LOG_DBG("ENC28J60 init complete!");
 
         return TRUE;
 }
+
+
+
+const macphy_ops_t Enc28j60MacPhyOps = {
+        .name = "ENC28J60",
+        .init = enc28j60_init,
+        .periodic_fn = enc28j60_periodic_fn,
+        .pkt_send = enc28j60_pkt_send,
+        .mpool_send = enc28j60_mpool_send,
+        .pkt_recv = enc28j60_pkt_recv,
+        .rx_pending = enc28j60_rx_pending,
+        .tx_credit = enc28j60_tx_credit,
+        .get_tx_err_counters = enc28j60_get_tx_err_counters,
+        .spi_status = NULL,
+        .set_rx_classifier = enc28j60_set_rx_classifier,
+        .irq_notify = enc28j60_irq_notify,
+        .rx_polling = enc28j60_rx_polling,
+        .frags_send = enc28j60_frags_send,
+        .get_rx_ts = enc28j60_get_rx_ts,
+        .tx_service = enc28j60_tx_service
+};
@@ -21,6 +21,11 @@
 #ifndef ETH_ENC28J60_H
 #define ETH_ENC28J60_H
 
+#include <Eth_GeneralTypes.h>
+#include <Eth_cfg.h>
+#include <macphy_mpool.h>
+#include <macphy_ops.h>
+
 #include "enc28j60_regs.h"
 
 
@@ -48,16 +53,176 @@ typedef enum {
 
 
 
+// Completion callback of the non-blocking PHY access
+typedef void (*enc28j60_phy_cbk_t)(uint8 phyaddr, uint16 data);
+
+
+// SPI transaction categories for bus utilization profiling
+typedef enum {
+        SPI_CAT_BANK_SWITCH,
+        SPI_CAT_CTRL_REG_RD,
+        SPI_CAT_CTRL_REG_WR,
+        SPI_CAT_MAC_MII_REG,
+        SPI_CAT_PHY_ACCESS,
+        SPI_CAT_BIT_SET_CLR,
+        SPI_CAT_RBM_STATUS, /* Rx header & transmit status vector reads */
+        SPI_CAT_RBM_PAYLOAD,
+        SPI_CAT_WBM_PAYLOAD,
+        SPI_CAT_SYS_CMD,
+        MAX_SPI_CAT
+} enc28j60_spi_cat_t;
+
+
+// Link state, updated only when the PHY raises a link change interrupt
+typedef struct {
+        uint16  phstat1;
+        uint16  phstat2;
+        uint32  flaps;          /* number of link losses */
+        uint32  last_flap_ms;   /* uptime of the last link loss */
+        uint32  last_change_ms; /* uptime of the last link up / down change */
+        boolean link_up;
+        boolean full_duplex;
+} enc28j60_link_info_t;
+
+
+// Rx buffer fill and PAUSE frame flow control, fill levels are in bytes
+typedef struct {
+        uint16  hi_mark;        /* start sending PAUSE frames at this fill */
+        uint16  lo_mark;        /* stop sending PAUSE frames at this fill */
+        uint16  fill;           /* fill seen at the last Rx service */
+        uint16  peak_fill;
+        uint32  pause_events;   /* number of times the PAUSE frames were started */
+        uint32  overflows;      /* Rx buffer overflows (EIR.RXERIF), frames lost */
+        boolean paused;
+} enc28j60_rx_flow_t;
+
+
+// Buffer sizing telemetry, the *_ms fields are the uptime of the last time
+// the high-water mark was reached or the event was seen
+typedef struct {
+        uint16  rx_fill_hwm;            /* Rx buffer fill in bytes (ERXWRPT - ERXRDPT) */
+        uint32  rx_fill_hwm_ms;
+        uint8   pktcnt_hwm;             /* EPKTCNT */
+        uint32  pktcnt_hwm_ms;
+        uint32  rx_overflows;           /* EIR.RXERIF */
+        uint32  rx_overflow_ms;
+        uint32  buf_errors;             /* ESTAT.BUFER */
+        uint32  buf_error_ms;
+        uint32  link_down_pending;      /* link downs with Tx frames waiting */
+        uint32  link_down_pending_ms;   /* total time spent so */
+        uint32  link_down_last_ms;      /* start of the last one */
+} enc28j60_telemetry_t;
+
+
+// Adaptive Rx interrupt / polling mode, coalescing settings and statistics
+typedef struct {
+        boolean polling;        /* PKTIE is masked, EPKTCNT is polled */
+        uint8   coal_frames;    /* EPKTCNT that starts the polling */
+        uint16  coal_usec;      /* interrupt gap that starts the polling */
+        uint16  poll_budget;    /* frames polled before PKTIE is unmasked */
+        uint32  irqs;
+        uint32  to_poll;        /* mode switches */
+        uint32  to_irq;
+        uint32  irq_frames;     /* frames read in each mode */
+        uint32  poll_frames;
+        uint32  lat_max_us;     /* interrupt to frame read latency */
+        uint32  lat_sum_us;
+        uint32  lat_cnt;
+} enc28j60_rx_mode_t;
+
+
+// Frames not read in full due to the Rx classifier
+typedef struct {
+        uint32  dropped;
+        uint32  hdr_only;
+        uint32  bytes_saved;    /* frame bytes that were not read over SPI */
+} enc28j60_rx_class_stats_t;
+
+
+// Frames answered from within the MACPHY
+typedef struct {
+        uint32  arp_replies;
+        uint32  icmp_replies;
+        uint32  busy_fallbacks; /* Tx was busy, given to the upper layers */
+} enc28j60_fast_resp_stats_t;
+
+
+// Headers of a cyclic Tx stream, see enc28j60_stream_register
+typedef struct {
+        const uint8 *hdr;       /* Eth (+ VLAN) (+ IPv4 (+ UDP)) headers */
+        uint16  hdr_len;
+        uint16  ip_ofs;         /* offset of the IPv4 header in hdr, 0 if none */
+        uint16  udp_ofs;        /* offset of the UDP header in hdr, 0 if none, else hdr_len - 8 */
+} enc28j60_stream_cfg_t;
+
+
+typedef struct {
+        uint32 xfers[MAX_SPI_CAT];
+        uint32 bytes[MAX_SPI_CAT];  /* incl. opcode and dummy bytes */
+        uint32 total_bytes;
+        uint32 payload_bytes;       /* Eth frame bytes moved by RBM / WBM */
+        uint64 busy_cycles;         /* time spent in Spi_SyncTransmit */
+} enc28j60_spi_prof_t;
+
+
+// Chunked RBM / WBM, see enc28j60_set_spi_chunking
+typedef void (*enc28j60_spi_arb_cbk_t)(void);
+
+typedef struct {
+        uint16 chunk_len;           /* max. frame bytes per RBM / WBM, 0 = not split */
+        uint8  express_prio;        /* Tx FIFO prio that may go ahead of an Rx read */
+        uint32 chunks;              /* RBM / WBM transfers done as chunks */
+        uint32 arb_points;          /* bus given up between the chunks */
+        uint32 express_frames;      /* frames sent in the middle of an Rx read */
+        uint32 max_block_us;        /* longest single Spi_SyncTransmit */
+        uint16 max_block_len;       /* its length in bytes */
+} enc28j60_spi_arb_t;
+
+
+
 // Macros
 #define LO_BYTE(x) ((uint8)((x) & 0xFF))
 #define HI_BYTE(x) ((uint8)((x) >> 8))
 
 
-// public functions
-boolean macphy_init(const uint8 *mac_addr);
-void macphy_periodic_fn(void);
-boolean macphy_pkt_send(uint8 *pktptr, uint16 pktlen);
-uint16  macphy_pkt_recv(uint8 *pktptr, uint16 maxlen);
+// public functions, called via Enc28j60MacPhyOps
+extern const macphy_ops_t Enc28j60MacPhyOps;
+
+boolean enc28j60_init(const Eth_ConfigType *cfg);
+void    enc28j60_periodic_fn(void);
+void    enc28j60_tx_service(void);
+boolean enc28j60_pkt_send(uint8 *pktptr, uint16 pktlen);
+boolean enc28j60_mpool_send(spi_mpool_t *mpool);
+boolean enc28j60_frags_send(const macphy_frag_t *frags, uint8 nfrags);
+uint16  enc28j60_pkt_recv(uint8 *pktptr, uint16 maxlen);
+uint8   enc28j60_rx_pending(void);
+boolean enc28j60_get_rx_ts(macphy_ts_t *ts);
+uint8   enc28j60_tx_credit(void);
+void    enc28j60_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs);
+
+void   enc28j60_get_link_info(enc28j60_link_info_t *info);
+void   enc28j60_get_rx_flow_info(enc28j60_rx_flow_t *info);
+boolean enc28j60_set_rx_watermarks(uint16 hi_mark, uint16 lo_mark);
+void   enc28j60_irq_notify(void);
+boolean enc28j60_rx_polling(void);
+void   enc28j60_set_rx_coalescing(uint8 frames, uint16 usec, uint16 poll_budget);
+void   enc28j60_get_rx_mode_info(enc28j60_rx_mode_t *info);
+void   enc28j60_set_rx_classifier(macphy_rx_classify_t fn);
+void   enc28j60_get_rx_class_stats(enc28j60_rx_class_stats_t *stats);
+void   enc28j60_set_fast_resp_ip(const uint8 *ip_addr);
+void   enc28j60_get_fast_resp_stats(enc28j60_fast_resp_stats_t *stats);
+boolean enc28j60_stream_register(const enc28j60_stream_cfg_t *cfg, uint8 *id);
+void   enc28j60_stream_unregister(uint8 id);
+boolean enc28j60_stream_send(uint8 id, const uint8 *payload, uint16 plen);
+void   enc28j60_get_telemetry(enc28j60_telemetry_t *tlm);
+void   enc28j60_reset_telemetry(void);
+boolean enc28j60_set_spi_chunking(uint16 chunk_len, uint8 express_prio);
+void   enc28j60_set_spi_arbiter(enc28j60_spi_arb_cbk_t cbk);
+void   enc28j60_get_spi_arb_info(enc28j60_spi_arb_t *info);
+void   enc28j60_reset_spi_block_time(void);
+void   enc28j60_get_spi_prof(enc28j60_spi_prof_t *prof);
+void   enc28j60_reset_spi_prof(void);
+uint16 enc28j60_spi_efficiency(void);
 
 
 // private functions
@@ -68,6 +233,8 @@ boolean enc28j60_bitclr_reg(uint16 reg, uint8 data);
 
 uint16 enc28j60_read_phy(uint8 phyaddr);
 boolean enc28j60_write_phy(uint8 phyaddr, uint16 data);
+boolean enc28j60_read_phy_async(uint8 phyaddr, enc28j60_phy_cbk_t done);
+boolean enc28j60_write_phy_async(uint8 phyaddr, uint16 data, enc28j60_phy_cbk_t done);
 
 
 #endif
@@ -2,5 +2,4 @@ INCDIRS  += -I ${ETH_PATH}/src/macphy/enc28j60
 
 
 ETH_OBJS += \
-	${ETH_PATH}/src/macphy/macphy_mpool.o \
-	${ETH_PATH}/src/macphy/enc28j60/enc28j60.o 
\ No newline at end of file
+	${ETH_PATH}/src/macphy/enc28j60/enc28j60.o
@@ -50,6 +50,7 @@
 
 // ENC28J60 ESTAT Register Bit Definitions
 #define ESTAT_INT 	(0x80)
+#define ESTAT_BUFER 	(0x40)
 #define ESTAT_LATECOL  	(0x10)
 #define ESTAT_RXBUSY    (0x04)
 #define ESTAT_TXABRT    (0x02)
@@ -218,6 +219,15 @@
 #define MACON2_MATXRST  (0x02)
 #define MACON2_TFUNRST  (0x01)
 
+// ENC28J60 EFLOCON Register Bit Definitions
+#define EFLOCON_FULDPXS (0x04)
+#define EFLOCON_FCEN1   (0x02)
+#define EFLOCON_FCEN0   (0x01)
+#define EFLOCON_FC_OFF  (0x00)                          /* flow control off */
+#define EFLOCON_FC_ONE  (EFLOCON_FCEN0)                 /* one PAUSE with EPAUS, then off */
+#define EFLOCON_FC_XOFF (EFLOCON_FCEN1)                 /* PAUSE with EPAUS, periodically */
+#define EFLOCON_FC_XON  (EFLOCON_FCEN1 | EFLOCON_FCEN0) /* one PAUSE with 0 time, then off */
+
 // ENC28J60 MACON3 Register Bit Definitions
 #define MACON3_PADCFG2  (0x80)
 #define MACON3_PADCFG1  (0x40)
@@ -250,6 +260,22 @@
 #define PHSTAT1_LLSTAT  (0x0004)
 #define PHSTAT1_JBSTAT  (0x0002)
 
+// ENC28J60 PHY PHSTAT2 Register Bit Definitions
+#define PHSTAT2_TXSTAT  (0x2000)
+#define PHSTAT2_RXSTAT  (0x1000)
+#define PHSTAT2_COLSTAT (0x0800)
+#define PHSTAT2_LSTAT   (0x0400)
+#define PHSTAT2_DPXSTAT (0x0200)
+#define PHSTAT2_PLRITY  (0x0020)
+
+// ENC28J60 PHY PHIE Register Bit Definitions
+#define PHIE_PLNKIE     (0x0010)
+#define PHIE_PGEIE      (0x0002)
+
+// ENC28J60 PHY PHIR Register Bit Definitions
+#define PHIR_PLNKIF     (0x0010)
+#define PHIR_PGIF       (0x0004)
+
 // ENC28J60 PHY PHCON2 Register Bit Definitions
 #define PHCON2_FRCLNK   (0x4000)
 #define PHCON2_TXDIS    (0x2000)
@@ -257,4 +283,35 @@
 #define PHCON2_HDLDIS   (0x0100)
 
 
+
+/////////////////////////////////////////
+///  ENC28J60 TRANSMIT STATUS VECTOR   //
+/////////////////////////////////////////
+// 7 bytes written by the MAC at ETXND+1, refer table 7-1 of datasheet
+#define TSV_SZ          (7)
+
+// TSV byte 2 - bits[23:16]
+#define TSV2_DONE       (0x80)
+#define TSV2_LENOOR     (0x40)
+#define TSV2_LENCHKERR  (0x20)
+#define TSV2_CRCERR     (0x10)
+#define TSV2_COLCNT     (0x0F)
+
+// TSV byte 3 - bits[31:24]
+#define TSV3_UNDERRUN   (0x80)
+#define TSV3_GIANT      (0x40)
+#define TSV3_LATECOL    (0x20)
+#define TSV3_EXCCOL     (0x10)
+#define TSV3_EXCDEFER   (0x08)
+#define TSV3_DEFER      (0x04)
+#define TSV3_BCAST      (0x02)
+#define TSV3_MCAST      (0x01)
+
+// TSV byte 6 - bits[55:48]
+#define TSV6_VLAN       (0x08)
+#define TSV6_BACKPRESS  (0x04)
+#define TSV6_PAUSE      (0x02)
+#define TSV6_CTRLFRM    (0x01)
+
+
 #endif
@@ -0,0 +1,719 @@
+/*
+ * Created on Mon Oct 19 2026 4:02:51 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Spi.h>
+#include <os_api.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include "enc424j600.h"
+#include <macphy_mpool.h>
+#include <macphy_trace.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(enc424j600, LOG_LEVEL_DBG);
+
+
+// number of polls of a hardware flag before giving up, 10 us apart
+#define ENC424J600_POLL_CNT             100
+
+// hardware flow control: PAUSE frames when the Rx buffer is above the full
+// watermark until it goes below the empty watermark, in units of 96 bytes
+#define ENC424J600_RX_FULL_WM           (RX_BUF_SZ * 3 / 4 / 96)
+#define ENC424J600_RX_EMPTY_WM          (RX_BUF_SZ / 4 / 96)
+
+
+// Memory Buffer Layout (24k): Tx slots, each holds a frame, then the Rx ring
+#define ENC424J600_TX_SLOTS     (8)
+#define TX_SLOT_SZ              (0x0600)
+#define TX_BUF_BEG              (0x0000)
+#define RX_BUF_BEG              (TX_BUF_BEG + ENC424J600_TX_SLOTS * TX_SLOT_SZ)
+#define RX_BUF_END              (0x5FFF)
+#define RX_BUF_SZ               (RX_BUF_END - RX_BUF_BEG + 1)
+
+#define MAX_ETH_FRAME_LEN       (1522)
+#define RX_PKT_HDR_SZ           (8) /* 2 byte next pkt pointer + rx status vector */
+#define ETH_FCS_LEN             (4)
+
+
+// Macros
+#define LO_BYTE(x) ((uint8)((x) & 0xFF))
+#define HI_BYTE(x) ((uint8)((x) >> 8))
+
+
+static const EthCtrlOffloadingType *Offload;
+static enc424j600_stats_t Stats;
+static Eth_TxErrorCounterValuesType TxErrCounters;
+
+// Tx slots in the SRAM, filled in order and sent from TxSlotHead
+static uint16  TxSlotLen[ENC424J600_TX_SLOTS];
+static uint32  TxSlotSeq[ENC424J600_TX_SLOTS];
+static uint8   TxSlotHead;
+static boolean TxBusy;          /* frame of TxSlotHead is with the MAC */
+
+static uint16 RxNextPkt;
+static uint8  RxPktsPending;
+
+static uint8 SpiBasicTx[16];
+static uint8 SpiBasicRx[16];
+
+
+// Checksum work for the DMA, found while the frame is still in the host memory
+typedef struct {
+        uint16 l4_ofs;          /* start of the L4 header in the frame */
+        uint16 l4_len;
+        uint16 cksum_ofs;       /* checksum field in the frame */
+        uint32 pseudo_sum;      /* partial sum of the IPv4 pseudo header */
+        uint8  proto;
+} enc424j600_cksum_t;
+
+
+
+//////////////////////////////////////////////
+// Local Functions
+static Std_ReturnType enc424j600_spi_xfer(uint8 *txbuf, uint8 *rxbuf, uint16 len) {
+        Spi_SetupEB(0, txbuf, rxbuf, len);
+        return Spi_SyncTransmit(SEQ_ETHERNET_BASIC_TX_RX);
+}
+
+
+
+static boolean enc424j600_cmd(uint8 opcode) {
+        SpiBasicTx[0] = opcode;
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, 1)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+/* writes one of the SRAM pointers, opcode selects the pointer */
+static boolean enc424j600_write_ptr(uint8 opcode, uint16 ptr) {
+        SpiBasicTx[0] = opcode;
+        SpiBasicTx[1] = LO_BYTE(ptr);
+        SpiBasicTx[2] = HI_BYTE(ptr);
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, 3)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+/* 16 bit sum in the memory byte order, i.e., the checksum bytes are to be
+** stored low byte first. RFC 1071 makes it independent of the byte order. */
+static uint32 enc424j600_sum16(const uint8 *p, uint16 len, uint32 sum) {
+        uint16 i;
+
+        for (i = 0; i+1 < len; i += 2) {
+                sum += p[i] | (p[i+1] << 8);
+        }
+        if (len & 1) {
+                sum += p[len-1];
+        }
+
+        return sum;
+}
+
+
+static uint16 enc424j600_fold(uint32 sum) {
+        while (sum >> 16) {
+                sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+
+        return (uint16) sum;
+}
+
+
+
+/* Fills the IPv4 header checksum and finds the L4 checksum work as per the
+** offload config. Returns FALSE if the DMA has nothing to do for this frame. */
+static boolean enc424j600_cksum_prep(uint8 *frame, uint16 len, enc424j600_cksum_t *ck) {
+        uint16 l3, ihl, ip_len, csum;
+        uint8 *ip;
+
+        l3 = 14;
+        if ((frame[12] == 0x81) && (frame[13] == 0x00)) {
+                l3 += 4; // VLAN tag
+        }
+        if ((len < l3 + 20) || (frame[l3-2] != 0x08) || (frame[l3-1] != 0x00)) {
+                return FALSE; // not IPv4
+        }
+
+        ip = frame + l3;
+        ihl = (ip[0] & 0x0F) * 4;
+        ip_len = (ip[2] << 8) | ip[3];
+        if ((ihl < 20) || (ip_len < ihl) || (l3 + ip_len > len)) {
+                return FALSE;
+        }
+
+        if (Offload->en_cksum_ipv4) {
+                ip[10] = ip[11] = 0;
+                csum = ~enc424j600_fold(enc424j600_sum16(ip, ihl, 0));
+                ip[10] = LO_BYTE(csum);
+                ip[11] = HI_BYTE(csum);
+        }
+
+        /* fragments carry a part of the L4 segment only */
+        if ((ip[6] & 0x3F) || ip[7]) {
+                return FALSE;
+        }
+
+        ck->l4_ofs = l3 + ihl;
+        ck->l4_len = ip_len - ihl;
+        ck->pseudo_sum = 0;
+        ck->proto = ip[9];
+        switch (ck->proto) {
+        case 1: /* ICMP, no pseudo header */
+                if (!Offload->en_cksum_icmp || (ck->l4_len < 4)) {
+                        return FALSE;
+                }
+                ck->cksum_ofs = ck->l4_ofs + 2;
+                break;
+        case 6: /* TCP */
+                if (!Offload->en_cksum_tcp || (ck->l4_len < 20)) {
+                        return FALSE;
+                }
+                ck->cksum_ofs = ck->l4_ofs + 16;
+                break;
+        case 17: /* UDP */
+                if (!Offload->en_cksum_udp || (ck->l4_len < 8)) {
+                        return FALSE;
+                }
+                ck->cksum_ofs = ck->l4_ofs + 6;
+                break;
+        default:
+                return FALSE;
+        }
+
+        if (ck->proto != 1) {
+                /* src / dst address, zero + protocol, L4 length */
+                ck->pseudo_sum = enc424j600_sum16(ip+12, 8, 0);
+                ck->pseudo_sum += (ip[9] << 8);
+                ck->pseudo_sum += HI_BYTE(ck->l4_len) | (LO_BYTE(ck->l4_len) << 8);
+        }
+        frame[ck->cksum_ofs] = frame[ck->cksum_ofs+1] = 0;
+
+        return TRUE;
+}
+
+
+
+/* Lets the DMA sum up the L4 segment that is in the SRAM already, then adds
+** the pseudo header and writes the checksum into the SRAM copy of the frame. */
+static boolean enc424j600_cksum_dma(uint16 frame_addr, const enc424j600_cksum_t *ck) {
+        uint16 i, dma_cs, csum;
+
+        enc424j600_write_reg(EDMAST, frame_addr + ck->l4_ofs);
+        enc424j600_write_reg(EDMALEN, ck->l4_len);
+        enc424j600_bitclr_reg(ECON1, ECON1_DMACPY | ECON1_DMANOCS | ECON1_DMACSSD);
+        enc424j600_bitset_reg(ECON1, ECON1_DMAST);
+        for (i = 0; i < ENC424J600_POLL_CNT; i++) {
+                if ((enc424j600_read_reg(ECON1) & ECON1_DMAST) == 0) {
+                        break;
+                }
+                k_busy_wait(10);
+        }
+        if (i == ENC424J600_POLL_CNT) {
+                LOG_ERR("%s(): DMA checksum timeout!", __func__);
+                return FALSE;
+        }
+
+        /* EDMACS is the complemented sum, low byte is the first in memory */
+        dma_cs = enc424j600_read_reg(EDMACS);
+        csum = ~enc424j600_fold(ck->pseudo_sum + (uint16)(~dma_cs));
+        if ((ck->proto == 17) && (csum == 0)) {
+                csum = 0xFFFF;
+        }
+
+        enc424j600_write_ptr(WGPWRPT_OPCODE, frame_addr + ck->cksum_ofs);
+        SpiBasicTx[0] = WGPDATA_OPCODE;
+        SpiBasicTx[1] = LO_BYTE(csum);
+        SpiBasicTx[2] = HI_BYTE(csum);
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, 3)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+/* Copies the frames of the Tx FIFO into the free Tx slots of the SRAM. This
+** can go on while the MAC sends an earlier slot. */
+static void enc424j600_tx_load(void) {
+        enc424j600_cksum_t ck;
+        spi_mpool_t *mpool;
+        uint16 addr;
+        uint8 slot, *frame;
+        boolean do_cksum;
+
+        while ((Stats.tx_slots_used < ENC424J600_TX_SLOTS) && (get_spi_mpool_tx_queued() > 0)) {
+                mpool = get_spi_mpool_w_data();
+                slot = (TxSlotHead + Stats.tx_slots_used) % ENC424J600_TX_SLOTS;
+                addr = TX_BUF_BEG + slot * TX_SLOT_SZ;
+                frame = mpool->tx_buf + MEM_POOL_TX_DATA_OFS;
+
+                do_cksum = enc424j600_cksum_prep(frame, mpool->dlen, &ck);
+
+                MACPHY_TRACE(TRC_TX_SPI_WR_START, mpool->seq);
+                enc424j600_write_ptr(WGPWRPT_OPCODE, addr);
+                mpool->tx_buf[MEM_POOL_TX_DATA_OFS-1] = WGPDATA_OPCODE;
+                if (E_NOT_OK == enc424j600_spi_xfer(mpool->tx_buf + MEM_POOL_TX_DATA_OFS-1,
+                        mpool->rx_buf, mpool->dlen+1)) {
+                        LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                        TxErrCounters.TxDroppedErrorPkts++;
+                        free_spi_mpool(mpool);
+                        continue;
+                }
+                if (do_cksum && enc424j600_cksum_dma(addr, &ck)) {
+                        Stats.tx_cksum_frames++;
+                }
+                MACPHY_TRACE(TRC_TX_SPI_WR_DONE, mpool->seq);
+
+                TxSlotLen[slot] = mpool->dlen;
+                TxSlotSeq[slot] = mpool->seq;
+                Stats.tx_slots_used++;
+
+                /* the frame is with the MACPHY now */
+                if (mpool->tx_confirm) {
+                        put_spi_mpool_tx_done(mpool);
+                }
+                free_spi_mpool(mpool);
+        }
+}
+
+
+
+static void enc424j600_tx_status(void) {
+        uint16 txstat = enc424j600_read_reg(ETXSTAT);
+        uint8 colcnt = txstat & ETXSTAT_COLCNT;
+
+        MACPHY_TRACE(TRC_TX_COMPLETE, TxSlotSeq[TxSlotHead]);
+        if (colcnt == 1) {
+                TxErrCounters.TxSingleCollision++;
+        }
+        else if (colcnt > 1) {
+                TxErrCounters.TxMultipleCollision++;
+        }
+        if (txstat & (ETXSTAT_DEFER | ETXSTAT_EXDEFER)) {
+                TxErrCounters.TxDeferredTrans++;
+        }
+        if (txstat & ETXSTAT_LATECOL) {
+                TxErrCounters.TxLateCollision++;
+        }
+        if (txstat & ETXSTAT_MAXCOL) {
+                TxErrCounters.TxExcessiveCollison++;
+        }
+}
+
+
+
+/* Retires the slot the MAC has finished and starts the next one */
+static void enc424j600_tx_kick(void) {
+        uint8 slot;
+
+        if (TxBusy) {
+                if (enc424j600_read_reg(ECON1) & ECON1_TXRTS) {
+                        return;
+                }
+                enc424j600_tx_status();
+                TxBusy = FALSE;
+                TxSlotHead = (TxSlotHead + 1) % ENC424J600_TX_SLOTS;
+                Stats.tx_slots_used--;
+                Stats.tx_frames++;
+        }
+
+        if ((Stats.tx_slots_used == 0) || (Stats.link_up == FALSE)) {
+                return;
+        }
+
+        slot = TxSlotHead;
+        enc424j600_write_reg(ETXST, TX_BUF_BEG + slot * TX_SLOT_SZ);
+        enc424j600_write_reg(ETXLEN, TxSlotLen[slot]);
+        enc424j600_cmd(SETTXRTS_OPCODE);
+        MACPHY_TRACE(TRC_TX_TXRTS_SET, TxSlotSeq[slot]);
+        TxBusy = TRUE;
+}
+
+
+
+/* The MAC duplex has to follow the PHY after auto-negotiation */
+static void enc424j600_update_link(uint16 estat) {
+        boolean link_up = (estat & ESTAT_PHYLNK) ? TRUE : FALSE;
+        boolean full_duplex = (estat & ESTAT_PHYDPX) ? TRUE : FALSE;
+        uint16 macon2 = MACON2_DEFER | MACON2_PADCFG_AUTO | MACON2_TXCRCEN | MACON2_RSVD1;
+
+        if (link_up != Stats.link_up) {
+                Stats.link_changes++;
+                LOG_INF("ENC424J600 link %s, %s duplex", link_up ? "up" : "down",
+                        full_duplex ? "full" : "half");
+        }
+        Stats.link_up = link_up;
+
+        if (link_up) {
+                enc424j600_write_reg(MACON2, macon2 | (full_duplex ? MACON2_FULDPX : 0));
+                enc424j600_write_reg(MABBIPG, full_duplex ? 0x15 : 0x12);
+                Stats.full_duplex = full_duplex;
+        }
+}
+
+
+
+static boolean enc424j600_reset(void) {
+        uint16 i;
+
+        /* wait for the SPI to come up, EUDAST reads back what is written */
+        for (i = 0; i < ENC424J600_POLL_CNT; i++) {
+                enc424j600_write_reg(EUDAST, 0x1234);
+                if (enc424j600_read_reg(EUDAST) == 0x1234) {
+                        break;
+                }
+                k_busy_wait(10);
+        }
+        for (; i < ENC424J600_POLL_CNT; i++) {
+                if (enc424j600_read_reg(ESTAT) & ESTAT_CLKRDY) {
+                        break;
+                }
+                k_busy_wait(10);
+        }
+        if (i == ENC424J600_POLL_CNT) {
+                LOG_ERR("%s(): ENC424J600 is not responding!", __func__);
+                return FALSE;
+        }
+
+        /* system reset clears EUDAST, the PHY needs 256 us more */
+        enc424j600_cmd(SETETHRST_OPCODE);
+        k_busy_wait(25);
+        if (enc424j600_read_reg(EUDAST) != 0) {
+                LOG_ERR("%s(): ENC424J600 reset failed!", __func__);
+                return FALSE;
+        }
+        k_busy_wait(256);
+
+        return TRUE;
+}
+
+
+
+//////////////////////////////////////////////
+// Basic ENC424J600 Primitive - Register R/W, unbanked so no bank switching
+uint16 enc424j600_read_reg(uint8 reg) {
+        SpiBasicTx[0] = RCRU_OPCODE;
+        SpiBasicTx[1] = reg;
+        SpiBasicTx[2] = 0x00; // dummy
+        SpiBasicTx[3] = 0x00; // dummy, address auto increments to the H byte
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, 4)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return 0xFFFF;
+        }
+
+        return SpiBasicRx[2] | (SpiBasicRx[3] << 8);
+}
+
+
+
+static boolean enc424j600_reg_op(uint8 opcode, uint8 reg, uint16 data) {
+        SpiBasicTx[0] = opcode;
+        SpiBasicTx[1] = reg;
+        SpiBasicTx[2] = LO_BYTE(data);
+        SpiBasicTx[3] = HI_BYTE(data);
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, 4)) {
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+boolean enc424j600_write_reg(uint8 reg, uint16 data) {
+        return enc424j600_reg_op(WCRU_OPCODE, reg, data);
+}
+
+
+
+boolean enc424j600_bitset_reg(uint8 reg, uint16 data) {
+        return enc424j600_reg_op(BFSU_OPCODE, reg, data);
+}
+
+
+
+boolean enc424j600_bitclr_reg(uint8 reg, uint16 data) {
+        return enc424j600_reg_op(BFCU_OPCODE, reg, data);
+}
+
+
+
+//////////////////////////////////////////////
+// Global Functions
+boolean enc424j600_pkt_send(uint8 *pktptr, uint16 pktlen) {
+        spi_mpool_t *mpool;
+
+        if ((pktptr == NULL) || (pktlen+MEM_POOL_TX_DATA_OFS > MEM_POOL_BUF_LEN)) {
+                return FALSE;
+        }
+
+        /* get memory pool for ethernet frame transfer, no pool = no Tx credit */
+        mpool = get_new_spi_mpool_tx();
+        if (mpool == NULL) {
+                TxErrCounters.TxDroppedNoErrorPkts++;
+                return FALSE;
+        }
+
+        MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+        memcpy(mpool->tx_buf+MEM_POOL_TX_DATA_OFS, pktptr, pktlen);
+        mpool->dlen = pktlen;
+
+        return enc424j600_mpool_send(mpool);
+}
+
+
+
+/* Queues a frame from a Tx pool, it is copied to a free Tx slot at once and
+** sent in order after the slots before it. */
+boolean enc424j600_mpool_send(spi_mpool_t *mpool) {
+        if (mpool == NULL) {
+                return FALSE;
+        }
+
+        if (FALSE == put_spi_mpool_w_data(mpool)) {
+                free_spi_mpool(mpool);
+                TxErrCounters.TxDroppedNoErrorPkts++;
+                return FALSE;
+        }
+
+        enc424j600_tx_load();
+        enc424j600_tx_kick();
+
+        return TRUE;
+}
+
+
+
+uint16 enc424j600_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+        spi_mpool_t *mpool;
+        uint8 *rx_pkt_hdr = SpiBasicRx+1; // +1 for RRXDATA_OPCODE
+        uint16 pktlen, nxtpkt, tail;
+        uint8 pktcnt;
+
+        /* check if any pkts are there in the Rx ring */
+        pktcnt = enc424j600_read_reg(ESTAT) & ESTAT_PKTCNT;
+        if (pktcnt == 0) {
+                RxPktsPending = 0;
+                return 0;
+        }
+        RxPktsPending = pktcnt - 1;
+
+        mpool = get_new_spi_mpool();
+        if (mpool == NULL) {
+                LOG_ERR("Can't recv eth pkt, no free mpool, increase SPI_MEM_POOL_SIZE!");
+                return 0;
+        }
+
+        /* read next pkt pointer and rx status vector, the Rx read pointer then
+        points to the frame, it wraps around within the Rx ring by itself */
+        if (FALSE == enc424j600_write_ptr(WRXRDPT_OPCODE, RxNextPkt)) {
+                free_spi_mpool(mpool);
+                return 0;
+        }
+        SpiBasicTx[0] = RRXDATA_OPCODE;
+        if (E_NOT_OK == enc424j600_spi_xfer(SpiBasicTx, SpiBasicRx, RX_PKT_HDR_SZ+1)) {
+                /* the ring is left as is, the frame is read again next time */
+                LOG_ERR("%s: Spi Sync Tx failure!", __func__);
+                free_spi_mpool(mpool);
+                return 0;
+        }
+        nxtpkt = rx_pkt_hdr[0] | (rx_pkt_hdr[1] << 8);
+        pktlen = (rx_pkt_hdr[2] | (rx_pkt_hdr[3] << 8)) - ETH_FCS_LEN;
+        if ((nxtpkt < RX_BUF_BEG) || (nxtpkt > RX_BUF_END) || (nxtpkt & 1)) {
+                /* a garbled header, freeing the ring up to it would lose the sync */
+                LOG_ERR("%s: bad next packet pointer 0x%04x!", __func__, nxtpkt);
+                Stats.rx_errors++;
+                free_spi_mpool(mpool);
+                return 0;
+        }
+
+        if (pktlen > maxlen) {
+                pktlen = maxlen;
+        }
+        if (pktlen > MEM_POOL_BUF_LEN-1) {
+                pktlen = MEM_POOL_BUF_LEN-1;
+        }
+
+        mpool->tx_buf[0] = RRXDATA_OPCODE;
+        if ((rx_pkt_hdr[4] & RSV2_RXOK) &&
+                (E_OK == enc424j600_spi_xfer(mpool->tx_buf, mpool->rx_buf, pktlen+1))) {
+                memcpy(pktptr, mpool->rx_buf+1, pktlen);
+                Stats.rx_frames++;
+        }
+        else {
+                pktlen = 0; // Rx error or the frame could not be read, hence ignore the packet
+                Stats.rx_errors++;
+        }
+        free_spi_mpool(mpool);
+
+        /* free the Rx ring up to the next frame, ERXTAIL stays 2 bytes behind it */
+        tail = (nxtpkt == RX_BUF_BEG) ? (RX_BUF_END - 1) : (nxtpkt - 2);
+        enc424j600_write_reg(ERXTAIL, tail);
+        enc424j600_cmd(SETPKTDEC_OPCODE);
+        RxNextPkt = nxtpkt;
+
+        return pktlen;
+}
+
+
+
+/* loads the Tx FIFO frames into free slots and starts the next one */
+void enc424j600_tx_service(void) {
+        enc424j600_tx_load();
+        enc424j600_tx_kick();
+}
+
+
+
+void enc424j600_periodic_fn(void) {
+        uint16 eir;
+
+        eir = enc424j600_read_reg(EIR);
+        if (eir & EIR_LINKIF) {
+                enc424j600_bitclr_reg(EIR, EIR_LINKIF);
+                enc424j600_update_link(enc424j600_read_reg(ESTAT));
+        }
+        if (eir & EIR_TXABTIF) {
+                /* TXRTS is cleared by the MAC, the slot is retired below */
+                enc424j600_bitclr_reg(EIR, EIR_TXABTIF);
+                TxErrCounters.TxDroppedErrorPkts++;
+        }
+        if (eir & (EIR_RXABTIF | EIR_PCFULIF)) {
+                enc424j600_bitclr_reg(EIR, EIR_RXABTIF | EIR_PCFULIF);
+                Stats.rx_aborts++;
+        }
+
+        enc424j600_tx_load();
+        enc424j600_tx_kick();
+}
+
+
+
+uint8 enc424j600_rx_pending(void) {
+        return RxPktsPending;
+}
+
+
+
+uint8 enc424j600_tx_credit(void) {
+        return (uint8) get_spi_mpool_tx_credit();
+}
+
+
+
+void enc424j600_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs) {
+        if (cntrs != NULL) {
+                *cntrs = TxErrCounters;
+        }
+}
+
+
+
+void enc424j600_get_stats(enc424j600_stats_t *stats) {
+        if (stats != NULL) {
+                *stats = Stats;
+        }
+}
+
+
+
+boolean enc424j600_init(const Eth_ConfigType *cfg) {
+        const uint8 *mac;
+
+        if (cfg == NULL) {
+                return FALSE;
+        }
+        mac = cfg->ctrlcfg.mac_addres;
+        Offload = &cfg->offload;
+
+        if (FALSE == enc424j600_reset()) {
+                return FALSE;
+        }
+
+        /* Rx ring after the Tx slots, ERXTAIL 2 bytes behind the read position */
+        enc424j600_write_reg(ERXST, RX_BUF_BEG);
+        enc424j600_write_reg(ERXTAIL, RX_BUF_END - 1);
+        RxNextPkt = RX_BUF_BEG;
+        TxSlotHead = 0;
+        TxBusy = FALSE;
+        Stats.tx_slots_used = 0;
+
+        /* set packet filter for reception */
+        enc424j600_write_reg(ERXFCON, ERXFCON_CRCEN | ERXFCON_RUNTEN | ERXFCON_UCEN | ERXFCON_BCEN);
+
+        /* MAC address, MAADR1 holds the first two bytes */
+        enc424j600_write_reg(MAADR1, mac[0] | (mac[1] << 8));
+        enc424j600_write_reg(MAADR2, mac[2] | (mac[3] << 8));
+        enc424j600_write_reg(MAADR3, mac[4] | (mac[5] << 8));
+        enc424j600_write_reg(MAMXFL, MAX_ETH_FRAME_LEN);
+
+        /* flow control by hardware on Rx buffer watermarks */
+        enc424j600_write_reg(ERXWM, (ENC424J600_RX_FULL_WM << 8) | ENC424J600_RX_EMPTY_WM);
+        enc424j600_bitset_reg(ECON2, ECON2_AUTOFC);
+
+        /* the MAC duplex follows the auto-negotiation result */
+        enc424j600_update_link(enc424j600_read_reg(ESTAT));
+
+        /* Enable packet receiption */
+        enc424j600_write_reg(EIE, EIE_INTIE | EIE_LINKIE | EIE_PKTIE | EIE_TXIE |
+                EIE_TXABTIE | EIE_RXABTIE | EIE_PCFULIE);
+        enc424j600_cmd(ENABLERX_OPCODE);
+
+        LOG_DBG("ENC424J600 init complete!");
+
+        return TRUE;
+}
+
+
+
+const macphy_ops_t Enc424j600MacPhyOps = {
+        .name = "ENC424J600",
+        .init = enc424j600_init,
+        .periodic_fn = enc424j600_periodic_fn,
+        .pkt_send = enc424j600_pkt_send,
+        .mpool_send = enc424j600_mpool_send,
+        .pkt_recv = enc424j600_pkt_recv,
+        .rx_pending = enc424j600_rx_pending,
+        .tx_credit = enc424j600_tx_credit,
+        .get_tx_err_counters = enc424j600_get_tx_err_counters,
+        .spi_status = NULL,
+        .set_rx_classifier = NULL,
+        .irq_notify = NULL,
+        .rx_polling = NULL,
+        .frags_send = NULL,
+        .get_rx_ts = NULL,
+        .tx_service = enc424j600_tx_service
+};
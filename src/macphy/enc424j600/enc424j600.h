@@ -0,0 +1,72 @@
+/*
+ * Created on Mon Oct 19 2026 4:02:51 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ETH_ENC424J600_H
+#define ETH_ENC424J600_H
+
+#include <Eth_GeneralTypes.h>
+#include <Eth_cfg.h>
+#include <macphy_mpool.h>
+#include <macphy_ops.h>
+
+#include "enc424j600_regs.h"
+
+
+/////////////////////////////////////////
+///   Declarations & Definitions       //
+/////////////////////////////////////////
+typedef struct {
+        uint32  tx_frames;
+        uint32  tx_cksum_frames;  /* frames with checksums done by the DMA */
+        uint32  rx_frames;
+        uint32  rx_errors;        /* RSV without Received OK, bad header or failed read */
+        uint32  rx_aborts;        /* EIR.RXABTIF, Rx buffer full */
+        uint32  link_changes;
+        uint8   tx_slots_used;    /* frames in SRAM waiting for the MAC */
+        boolean link_up;
+        boolean full_duplex;
+} enc424j600_stats_t;
+
+
+
+// public functions, called via Enc424j600MacPhyOps
+extern const macphy_ops_t Enc424j600MacPhyOps;
+
+boolean enc424j600_init(const Eth_ConfigType *cfg);
+void    enc424j600_periodic_fn(void);
+void    enc424j600_tx_service(void);
+boolean enc424j600_pkt_send(uint8 *pktptr, uint16 pktlen);
+boolean enc424j600_mpool_send(spi_mpool_t *mpool);
+uint16  enc424j600_pkt_recv(uint8 *pktptr, uint16 maxlen);
+uint8   enc424j600_rx_pending(void);
+uint8   enc424j600_tx_credit(void);
+void    enc424j600_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs);
+
+void    enc424j600_get_stats(enc424j600_stats_t *stats);
+
+
+// private functions
+uint16  enc424j600_read_reg(uint8 reg);
+boolean enc424j600_write_reg(uint8 reg, uint16 data);
+boolean enc424j600_bitset_reg(uint8 reg, uint16 data);
+boolean enc424j600_bitclr_reg(uint8 reg, uint16 data);
+
+
+#endif
@@ -0,0 +1,5 @@
+INCDIRS  += -I ${ETH_PATH}/src/macphy/enc424j600
+
+
+ETH_OBJS += \
+	${ETH_PATH}/src/macphy/enc424j600/enc424j600.o 
\ No newline at end of file
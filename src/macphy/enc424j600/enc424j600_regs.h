@@ -0,0 +1,173 @@
+/*
+ * Created on Mon Oct 19 2026 4:02:51 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ETH_ENC424J600_REGS_H
+#define ETH_ENC424J600_REGS_H
+
+
+/////////////////////////////////////////
+///    ENC424J600 INSTRUCTION SETS     //
+/////////////////////////////////////////
+// single byte instructions
+#define SETETHRST_OPCODE        (0xCA)
+#define SETPKTDEC_OPCODE        (0xCC)
+#define SETTXRTS_OPCODE         (0xD4)
+#define ENABLERX_OPCODE         (0xE8)
+#define DISABLERX_OPCODE        (0xEA)
+
+// three byte instructions, pointer value is sent low byte first
+#define WGPRDPT_OPCODE          (0x60)
+#define WRXRDPT_OPCODE          (0x64)
+#define WGPWRPT_OPCODE          (0x6C)
+
+// N byte instructions, unbanked ones take the register address as 2nd byte
+#define RCRU_OPCODE             (0x20)
+#define WCRU_OPCODE             (0x22)
+#define BFSU_OPCODE             (0x24)
+#define BFCU_OPCODE             (0x26)
+#define RGPDATA_OPCODE          (0x28)
+#define WGPDATA_OPCODE          (0x2A)
+#define RRXDATA_OPCODE          (0x2C)
+
+
+
+/////////////////////////////////////////
+///  ENC424J600 REGISTERS (UNBANKED)   //
+/////////////////////////////////////////
+// all are 16 bit, L byte at the address and H byte at address + 1
+#define ETXST           (0x00)
+#define ETXLEN          (0x02)
+#define ERXST           (0x04)
+#define ERXTAIL         (0x06)
+#define ERXHEAD         (0x08)
+#define EDMAST          (0x0A)
+#define EDMALEN         (0x0C)
+#define EDMADST         (0x0E)
+#define EDMACS          (0x10)
+#define ETXSTAT         (0x12)
+#define ETXWIRE         (0x14)
+#define EUDAST          (0x16)
+#define EUDAND          (0x18)
+#define ESTAT           (0x1A)
+#define EIR             (0x1C)
+#define ECON1           (0x1E)
+
+#define ERXFCON         (0x34)
+
+#define MACON1          (0x40)
+#define MACON2          (0x42)
+#define MABBIPG         (0x44)
+#define MAIPG           (0x46)
+#define MACLCON         (0x48)
+#define MAMXFL          (0x4A)
+
+#define MAADR3          (0x60)
+#define MAADR2          (0x62)
+#define MAADR1          (0x64)
+#define EPAUS           (0x6C)
+#define ECON2           (0x6E)
+#define ERXWM           (0x70)
+#define EIE             (0x72)
+#define EIDLED          (0x74)
+
+#define EGPRDPT         (0x86)
+#define EGPWRPT         (0x88)
+#define ERXRDPT         (0x8A)
+#define ERXWRPT         (0x8C)
+
+
+
+/////////////////////////////////////////
+///    Register Bit Definitions        //
+/////////////////////////////////////////
+// ESTAT
+#define ESTAT_INT       (0x8000)
+#define ESTAT_FCIDLE    (0x4000)
+#define ESTAT_RXBUSY    (0x2000)
+#define ESTAT_CLKRDY    (0x1000)
+#define ESTAT_PHYDPX    (0x0400)
+#define ESTAT_PHYLNK    (0x0100)
+#define ESTAT_PKTCNT    (0x00FF)
+
+// EIR
+#define EIR_LINKIF      (0x0800)
+#define EIR_PKTIF       (0x0040)
+#define EIR_DMAIF       (0x0020)
+#define EIR_TXIF        (0x0008)
+#define EIR_TXABTIF     (0x0004)
+#define EIR_RXABTIF     (0x0002)
+#define EIR_PCFULIF     (0x0001)
+
+// ECON1
+#define ECON1_PKTDEC    (0x0100)
+#define ECON1_DMAST     (0x0020)
+#define ECON1_DMACPY    (0x0010)
+#define ECON1_DMACSSD   (0x0008)
+#define ECON1_DMANOCS   (0x0004)
+#define ECON1_TXRTS     (0x0002)
+#define ECON1_RXEN      (0x0001)
+
+// ECON2
+#define ECON2_ETHEN     (0x8000)
+#define ECON2_STRCH     (0x4000)
+#define ECON2_TXMAC     (0x2000)
+#define ECON2_AUTOFC    (0x0080)
+#define ECON2_TXRST     (0x0040)
+#define ECON2_RXRST     (0x0020)
+#define ECON2_ETHRST    (0x0010)
+
+// EIE
+#define EIE_INTIE       (0x8000)
+#define EIE_LINKIE      (0x0800)
+#define EIE_PKTIE       (0x0040)
+#define EIE_DMAIE       (0x0020)
+#define EIE_TXIE        (0x0008)
+#define EIE_TXABTIE     (0x0004)
+#define EIE_RXABTIE     (0x0002)
+#define EIE_PCFULIE     (0x0001)
+
+// ERXFCON
+#define ERXFCON_CRCEN   (0x0040)
+#define ERXFCON_RUNTEN  (0x0010)
+#define ERXFCON_UCEN    (0x0008)
+#define ERXFCON_MCEN    (0x0002)
+#define ERXFCON_BCEN    (0x0001)
+
+// MACON2
+#define MACON2_DEFER    (0x4000)
+#define MACON2_PADCFG_AUTO (0x00A0) /* pad VLAN frames to 64, others to 60 bytes */
+#define MACON2_TXCRCEN  (0x0010)
+#define MACON2_HFRMEN   (0x0004)
+#define MACON2_RSVD1    (0x0002) /* reserved, keep as 1 */
+#define MACON2_FULDPX   (0x0001)
+
+// ETXSTAT
+#define ETXSTAT_LATECOL (0x0400)
+#define ETXSTAT_MAXCOL  (0x0200)
+#define ETXSTAT_EXDEFER (0x0100)
+#define ETXSTAT_DEFER   (0x0080)
+#define ETXSTAT_CRCBAD  (0x0010)
+#define ETXSTAT_COLCNT  (0x000F)
+
+// Receive Status Vector, byte 2
+#define RSV2_RXOK       (0x80)
+
+
+#endif
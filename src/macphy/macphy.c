@@ -0,0 +1,372 @@
+/*
+ * Created on Mon Oct 19 2026 2:14:05 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stddef.h>
+
+#include <string.h>
+#include <os_api.h>
+
+#include <macphy.h>
+#include <macphy_pcap.h>
+#include <macphy_trace.h>
+#include <macphy_ts.h>
+#include <macphy_txq.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(macphy, LOG_LEVEL_DBG);
+
+
+// Backend of the controller, selected by ctrlcfg.spi_device in macphy_init
+static const macphy_ops_t *MacPhyOps;
+
+// Given by the INT pin ISR and by Tx submissions, taken by the owner context
+static struct k_sem MacPhyEvt;
+
+
+
+static const macphy_ops_t* macphy_get_ops(EthControllerDevType dev) {
+        switch (dev) {
+        case ETH_DEV_ENC28J60:
+                return &Enc28j60MacPhyOps;
+        case ETH_DEV_ENC424J600:
+                return &Enc424j600MacPhyOps;
+        case ETH_DEV_TC6:
+                return &Tc6MacPhyOps;
+        default:
+                return NULL;
+        }
+}
+
+
+
+boolean macphy_init(const Eth_ConfigType *cfg) {
+        const macphy_ops_t *ops;
+
+        if (cfg == NULL) {
+                return FALSE;
+        }
+
+        ops = macphy_get_ops(cfg->ctrlcfg.spi_device);
+        if (ops == NULL) {
+                LOG_ERR("%s: unsupported MACPHY device %d!", __func__, cfg->ctrlcfg.spi_device);
+                return FALSE;
+        }
+
+        macphy_trace_init();
+        macphy_pcap_init();
+        macphy_txq_init();
+        k_sem_init(&MacPhyEvt, 0, 1);
+        LOG_DBG("This build uses MACPHY: %s", ops->name);
+        if (ops->init(cfg) == FALSE) {
+                return FALSE;
+        }
+        MacPhyOps = ops;
+
+        return TRUE;
+}
+
+
+
+/* hands the frames submitted from the other contexts to the backend */
+static void macphy_txq_drain(void) {
+#if MACPHY_TX_OWNER == 1
+        spi_mpool_t *mpool;
+
+        while ((mpool = macphy_txq_get()) != NULL) {
+                MACPHY_PCAP(MACPHY_PCAP_DIR_TX, mpool->tx_buf+MEM_POOL_TX_DATA_OFS, mpool->dlen);
+                MacPhyOps->mpool_send(mpool);
+        }
+#endif
+}
+
+
+
+/* The driver owner context: all SPI accesses are done from here, including
+** the frames submitted by the other tasks via macphy_mpool_send. */
+void macphy_periodic_fn(void) {
+        if (MacPhyOps == NULL) {
+                return;
+        }
+
+        macphy_txq_set_owner();
+        macphy_ts_now_ns(); // keeps the timestamp time base across the cycle counter wraps
+        macphy_txq_drain();
+        MacPhyOps->periodic_fn();
+}
+
+
+
+/* Only the Tx part of macphy_periodic_fn, cheap enough to be called between
+** the received frames, so that the Tx FIFO is drained within the budget of
+** the main function too */
+void macphy_tx_service(void) {
+        if (MacPhyOps == NULL) {
+                return;
+        }
+
+        macphy_txq_drain();
+        if (MacPhyOps->tx_service != NULL) {
+                MacPhyOps->tx_service();
+        }
+}
+
+
+
+boolean macphy_pkt_send(uint8 *pktptr, uint16 pktlen) {
+#if MACPHY_TX_OWNER == 1
+        spi_mpool_t *mpool;
+
+        if ((MacPhyOps == NULL) || (pktptr == NULL) ||
+                (pktlen+MEM_POOL_TX_DATA_OFS > MEM_POOL_BUF_LEN)) {
+                return FALSE;
+        }
+
+        mpool = get_new_spi_mpool_tx();
+        if (mpool == NULL) {
+                return FALSE;
+        }
+        MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+        memcpy(mpool->tx_buf+MEM_POOL_TX_DATA_OFS, pktptr, pktlen);
+        mpool->dlen = pktlen;
+
+        return macphy_mpool_send(mpool);
+#else
+        if (MacPhyOps == NULL) {
+                return FALSE;
+        }
+
+        MACPHY_PCAP(MACPHY_PCAP_DIR_TX, pktptr, pktlen);
+        return MacPhyOps->pkt_send(pktptr, pktlen);
+#endif
+}
+
+
+
+/* Safe to call from any task or ISR if MACPHY_TX_OWNER is 1, the frame is
+** then queued for the owner context and sent from macphy_periodic_fn. */
+boolean macphy_mpool_send(spi_mpool_t *mpool) {
+        if ((MacPhyOps == NULL) || (mpool == NULL)) {
+                return FALSE;
+        }
+
+#if MACPHY_TX_OWNER == 1
+        if (FALSE == macphy_txq_put(mpool)) {
+                free_spi_mpool(mpool);
+                return FALSE;
+        }
+        k_sem_give(&MacPhyEvt);
+
+        return TRUE;
+#else
+        MACPHY_PCAP(MACPHY_PCAP_DIR_TX, mpool->tx_buf+MEM_POOL_TX_DATA_OFS, mpool->dlen);
+        return MacPhyOps->mpool_send(mpool);
+#endif
+}
+
+
+
+uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+        uint16 len;
+
+        if (MacPhyOps == NULL) {
+                return 0;
+        }
+
+        len = MacPhyOps->pkt_recv(pktptr, maxlen);
+        if (len > 0) {
+                MACPHY_PCAP(MACPHY_PCAP_DIR_RX, pktptr, len);
+        }
+
+        return len;
+}
+
+
+
+uint8 macphy_rx_pending(void) {
+        if (MacPhyOps == NULL) {
+                return 0;
+        }
+
+        return MacPhyOps->rx_pending();
+}
+
+
+
+uint8 macphy_tx_credit(void) {
+        if (MacPhyOps == NULL) {
+                return 0;
+        }
+
+        return MacPhyOps->tx_credit();
+}
+
+
+
+void macphy_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs) {
+        if (MacPhyOps != NULL) {
+                MacPhyOps->get_tx_err_counters(cntrs);
+        }
+}
+
+
+
+uint32 macphy_spi_status(void) {
+        if ((MacPhyOps == NULL) || (MacPhyOps->spi_status == NULL)) {
+                return 0;
+        }
+
+        return MacPhyOps->spi_status();
+}
+
+
+
+/* The gathered frame is in no single buffer, its start is put together for
+** the capture */
+static void macphy_pcap_frags(const macphy_frag_t *frags, uint8 nfrags, uint16 len) {
+#if MACPHY_PCAP_ENABLE == 1
+        uint8 head[MACPHY_PCAP_SNAPLEN];
+        uint16 caplen = 0, n;
+        uint8 i;
+
+        for (i = 0; (i < nfrags) && (caplen < sizeof(head)); i++) {
+                n = sizeof(head) - caplen;
+                n = (frags[i].len < n) ? frags[i].len : n;
+                memcpy(head+caplen, frags[i].data, n);
+                caplen += n;
+        }
+        MACPHY_PCAP_PART(MACPHY_PCAP_DIR_TX, head, caplen, len);
+#else
+        (void) frags;
+        (void) nfrags;
+        (void) len;
+#endif
+}
+
+
+
+/* Sends a frame made of nfrags fragments. In the owner context the backend
+** streams them into the MACPHY one after the other if it can do so now, else
+** (and always in the other contexts) they are flattened into a Tx pool and
+** queued. A frame to be confirmed always takes a pool, its index is returned
+** in p_idx. The fragments are not used after the return. */
+boolean macphy_frags_send(const macphy_frag_t *frags, uint8 nfrags, boolean tx_confirm, uint32 *p_idx) {
+        spi_mpool_t *mpool;
+        uint16 len = 0;
+        uint8 i;
+
+        if ((MacPhyOps == NULL) || (frags == NULL) || (nfrags == 0)) {
+                return FALSE;
+        }
+        for (i = 0; i < nfrags; i++) {
+                if ((frags[i].data == NULL) && (frags[i].len > 0)) {
+                        return FALSE;
+                }
+                len += frags[i].len;
+        }
+        if (len+MEM_POOL_TX_DATA_OFS > MEM_POOL_BUF_LEN) {
+                return FALSE;
+        }
+
+        /* the frames submitted earlier go first */
+        if ((tx_confirm == FALSE) && macphy_txq_is_owner()) {
+                macphy_txq_drain();
+                if ((MacPhyOps->frags_send != NULL) && MacPhyOps->frags_send(frags, nfrags)) {
+                        macphy_pcap_frags(frags, nfrags, len);
+                        return TRUE;
+                }
+        }
+
+        mpool = get_new_spi_mpool_tx();
+        if (mpool == NULL) {
+                return FALSE;
+        }
+        MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+        mpool->dlen = 0;
+        for (i = 0; i < nfrags; i++) {
+                memcpy(mpool->tx_buf+MEM_POOL_TX_DATA_OFS+mpool->dlen, frags[i].data, frags[i].len);
+                mpool->dlen += frags[i].len;
+        }
+        mpool->tx_confirm = tx_confirm;
+        if (p_idx != NULL) {
+                *p_idx = get_spi_mpool_idx(mpool);
+        }
+
+        return macphy_mpool_send(mpool);
+}
+
+
+
+/* To be called from the ISR of the MACPHY INT pin (falling edge) */
+void macphy_irq_notify(void) {
+        const macphy_ops_t *ops = MacPhyOps;
+
+        if (ops == NULL) {
+                return;
+        }
+        if (ops->irq_notify != NULL) {
+                ops->irq_notify();
+        }
+        k_sem_give(&MacPhyEvt);
+}
+
+
+
+/* The owner context waits here between the Eth_MainFunction runs, e.g.,
+**     while (1) { macphy_wait_event(period_us); Eth_MainFunction(); }
+** It returns at once while the Rx is in polling mode or frames are pending,
+** else on an interrupt, a Tx submission or the timeout. Returns FALSE on
+** timeout. */
+boolean macphy_wait_event(uint32 timeout_us) {
+        if (MacPhyOps == NULL) {
+                return FALSE;
+        }
+
+        if (((MacPhyOps->rx_polling != NULL) && MacPhyOps->rx_polling()) ||
+                (MacPhyOps->rx_pending() > 0)) {
+                return TRUE;
+        }
+
+        return (k_sem_take(&MacPhyEvt, K_USEC(timeout_us)) == 0) ? TRUE : FALSE;
+}
+
+
+
+/* Sets the hook that decides on each received frame from its header prefix,
+** before the rest of it is read. NULL reads all frames in full. */
+boolean macphy_set_rx_classifier(macphy_rx_classify_t fn) {
+        if ((MacPhyOps == NULL) || (MacPhyOps->set_rx_classifier == NULL)) {
+                return FALSE;
+        }
+
+        MacPhyOps->set_rx_classifier(fn);
+        return TRUE;
+}
+
+
+
+/* Ingress timestamp of the frame returned by the last macphy_pkt_recv */
+boolean macphy_get_rx_ts(macphy_ts_t *ts) {
+        if ((MacPhyOps == NULL) || (MacPhyOps->get_rx_ts == NULL) || (ts == NULL)) {
+                return FALSE;
+        }
+
+        return MacPhyOps->get_rx_ts(ts);
+}
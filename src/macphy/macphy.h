@@ -1,9 +1,33 @@
 #ifndef NAMMA_AUTOSAR_MACPHY_H
 #define NAMMA_AUTOSAR_MACPHY_H
 
-#include <enc28j60/enc28j60.h>
+#include <macphy_ops.h>
 
 #define MACPHY_DEVICE  0xDEF
 
 
+// MACPHY backends, the register definitions stay within each backend
+extern const macphy_ops_t Enc28j60MacPhyOps;
+extern const macphy_ops_t Enc424j600MacPhyOps;
+extern const macphy_ops_t Tc6MacPhyOps;
+
+
+// MACPHY independent interface, dispatched to the backend of the controller
+boolean macphy_init(const Eth_ConfigType *cfg);
+void    macphy_periodic_fn(void);
+boolean macphy_pkt_send(uint8 *pktptr, uint16 pktlen);
+boolean macphy_mpool_send(spi_mpool_t *mpool);
+uint16  macphy_pkt_recv(uint8 *pktptr, uint16 maxlen);
+uint8   macphy_rx_pending(void);
+uint8   macphy_tx_credit(void);
+void    macphy_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs);
+uint32  macphy_spi_status(void);
+boolean macphy_set_rx_classifier(macphy_rx_classify_t fn);
+void    macphy_irq_notify(void);
+boolean macphy_wait_event(uint32 timeout_us);
+boolean macphy_frags_send(const macphy_frag_t *frags, uint8 nfrags, boolean tx_confirm, uint32 *p_idx);
+boolean macphy_get_rx_ts(macphy_ts_t *ts);
+void    macphy_tx_service(void);
+
+
 #endif
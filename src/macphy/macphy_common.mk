@@ -0,0 +1,27 @@
+# Not generated: the MACPHY layer objects that all backends use, and the
+# backends that macphy.c can select at run time; the one in macphy.mk is not
+# added twice
+
+
+ETH_OBJS += \
+	${ETH_PATH}/src/macphy/macphy.o \
+	${ETH_PATH}/src/macphy/macphy_mpool.o \
+	${ETH_PATH}/src/macphy/macphy_pcap.o \
+	${ETH_PATH}/src/macphy/macphy_rxpipe.o \
+	${ETH_PATH}/src/macphy/macphy_rxsteer.o \
+	${ETH_PATH}/src/macphy/macphy_trace.o \
+	${ETH_PATH}/src/macphy/macphy_ts.o \
+	${ETH_PATH}/src/macphy/macphy_txq.o
+
+
+ifeq ($(filter %/enc28j60.o,${ETH_OBJS}),)
+include ${ETH_PATH}/src/macphy/enc28j60/enc28j60.mk
+endif
+
+ifeq ($(filter %/enc424j600.o,${ETH_OBJS}),)
+include ${ETH_PATH}/src/macphy/enc424j600/enc424j600.mk
+endif
+
+ifeq ($(filter %/tc6.o,${ETH_OBJS}),)
+include ${ETH_PATH}/src/macphy/tc6/tc6.mk
+endif
@@ -19,42 +19,119 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
 #include "macphy_mpool.h"
 
 
 //////////////////////////////////////////////
 // BASIC ETHERNET Tx & Rx Buffers
 static spi_mpool_t SpiMemPool[SPI_MEM_POOL_SIZE];
+static atomic_t SpiMemPoolBusy; /* bit i set = SpiMemPool[i] is not free */
+static atomic_t SpiMemPoolTxSeq;
+
+// Tx FIFO and Tx confirmation FIFO, both hold at most all of the pools
+static spi_mpool_t* SpiMemPoolTxFifo[SPI_MEM_POOL_SIZE];
+static uint16 TxFifoHead, TxFifoCnt;
+typedef struct {
+        uint32 idx;
+        macphy_ts_t ts;
+} spi_mpool_tx_done_t;
+static spi_mpool_tx_done_t SpiMemPoolTxDone[SPI_MEM_POOL_SIZE];
+static uint16 TxDoneHead, TxDoneCnt;
+
+static spi_mpool_stats_t SpiMemPoolStats;
+
 
 
-// Memory Pool Functions
+static u16 spi_mpool_busy_cnt(atomic_val_t busy) {
+        u16 i, busy_cnt = 0;
+
+        for (i = 0; i < SPI_MEM_POOL_SIZE; i++) {
+                if (busy & (1 << i)) {
+                        busy_cnt++;
+                }
+        }
+
+        return busy_cnt;
+}
+
+
+
+static u16 get_spi_mpool_busy_cnt(void) {
+        return spi_mpool_busy_cnt(atomic_get(&SpiMemPoolBusy));
+}
+
+
+
+static void spi_mpool_busy_hwm(void) {
+        u16 busy_cnt = get_spi_mpool_busy_cnt();
+
+        if (busy_cnt >= SpiMemPoolStats.busy_hwm) {
+                SpiMemPoolStats.busy_hwm = busy_cnt;
+                SpiMemPoolStats.busy_hwm_ms = k_uptime_get_32();
+        }
+}
+
+
+// Memory Pool Functions, the pools are taken and freed with atomic bit ops so
+// that Tx pools can be taken from any task or ISR
 spi_mpool_t* get_new_spi_mpool(void) {
         spi_mpool_t* mpool_ptr = NULL;
         u16 i;
 
         for (i = 0; i < SPI_MEM_POOL_SIZE; i++) {
-                if (SpiMemPool[i].state == MPOOL_FREE) {
+                if (!atomic_test_and_set_bit(&SpiMemPoolBusy, i)) {
                         SpiMemPool[i].state = MPOOL_ACQUIRED;
                         mpool_ptr = &SpiMemPool[i];
                         break;
                 }
         }
 
+        if (mpool_ptr == NULL) {
+                SpiMemPoolStats.exhausted++;
+                SpiMemPoolStats.exhausted_ms = k_uptime_get_32();
+        }
+        else {
+                spi_mpool_busy_hwm();
+        }
+
         return mpool_ptr;
 }
 
 
 
-spi_mpool_t* get_spi_mpool_w_data(void) {
-        spi_mpool_t* mpool_ptr = NULL;
+/* Same as get_new_spi_mpool, but leaves SPI_MEM_POOL_RX_RESERVE pools for Rx.
+** The credit check and the claim are one CAS on the busy bits, so that two
+** producers can't both take the last pool above the reserve. */
+spi_mpool_t* get_new_spi_mpool_tx(void) {
+        spi_mpool_t* mpool_ptr;
+        atomic_val_t busy;
         u16 i;
 
-        for (i = 0; i < SPI_MEM_POOL_SIZE; i++) {
-                if (SpiMemPool[i].state == MPOOL_DATA_FILLED) {
-                        mpool_ptr = &SpiMemPool[i];
-                        break;
+        do {
+                busy = atomic_get(&SpiMemPoolBusy);
+                if (SPI_MEM_POOL_SIZE - spi_mpool_busy_cnt(busy) <= SPI_MEM_POOL_RX_RESERVE) {
+                        SpiMemPoolStats.tx_refused++;
+                        SpiMemPoolStats.tx_refused_ms = k_uptime_get_32();
+                        return NULL;
                 }
-        }
+                for (i = 0; busy & (1 << i); i++) {
+                        ; // there is a free pool, as the reserve is left
+                }
+        } while (!atomic_cas(&SpiMemPoolBusy, busy, busy | (1 << i)));
+
+        spi_mpool_busy_hwm();
+
+        mpool_ptr = &SpiMemPool[i];
+        mpool_ptr->state = MPOOL_ACQUIRED;
+        mpool_ptr->seq = (uint32) atomic_inc(&SpiMemPoolTxSeq);
+        mpool_ptr->tx_confirm = FALSE;
+        mpool_ptr->vlan = FALSE;
+        mpool_ptr->prio = 0;
+        mpool_ptr->tx_ts.valid = FALSE;
 
         return mpool_ptr;
 }
@@ -64,8 +141,9 @@ spi_mpool_t* get_spi_mpool_w_data(void) {
 boolean free_spi_mpool(spi_mpool_t* p_mpool) {
         boolean retval = TRUE;
 
-        if ((p_mpool >= SpiMemPool) && (p_mpool <= &SpiMemPool[SPI_MEM_POOL_SIZE])) {
+        if ((p_mpool >= SpiMemPool) && (p_mpool < &SpiMemPool[SPI_MEM_POOL_SIZE])) {
                 p_mpool->state = MPOOL_FREE;
+                atomic_clear_bit(&SpiMemPoolBusy, get_spi_mpool_idx(p_mpool));
         }
         else {
                 retval = FALSE;
@@ -73,3 +151,153 @@ boolean free_spi_mpool(spi_mpool_t* p_mpool) {
 
         return retval;
 }
+
+
+
+/* appends a filled pool to the Tx FIFO */
+boolean put_spi_mpool_w_data(spi_mpool_t* p_mpool) {
+        if (TxFifoCnt >= SPI_MEM_POOL_SIZE) {
+                return FALSE;
+        }
+
+        p_mpool->state = MPOOL_DATA_FILLED;
+        SpiMemPoolTxFifo[(TxFifoHead + TxFifoCnt) % SPI_MEM_POOL_SIZE] = p_mpool;
+        TxFifoCnt++;
+        if (TxFifoCnt >= SpiMemPoolStats.tx_queued_hwm) {
+                SpiMemPoolStats.tx_queued_hwm = TxFifoCnt;
+                SpiMemPoolStats.tx_queued_hwm_ms = k_uptime_get_32();
+        }
+
+        return TRUE;
+}
+
+
+
+/* position of the oldest pool of the highest prio in the Tx FIFO */
+static u16 get_spi_mpool_w_data_sel(void) {
+        u16 i, sel = 0;
+
+        for (i = 1; i < TxFifoCnt; i++) {
+                if (SpiMemPoolTxFifo[(TxFifoHead + i) % SPI_MEM_POOL_SIZE]->prio >
+                        SpiMemPoolTxFifo[(TxFifoHead + sel) % SPI_MEM_POOL_SIZE]->prio) {
+                        sel = i;
+                }
+        }
+
+        return sel;
+}
+
+
+
+/* removes and returns the oldest pool of the highest prio from the Tx FIFO,
+** the pools behind it move up to close the gap */
+spi_mpool_t* get_spi_mpool_w_data(void) {
+        spi_mpool_t* mpool_ptr = NULL;
+        u16 i, sel;
+
+        if (TxFifoCnt == 0) {
+                return NULL;
+        }
+
+        sel = get_spi_mpool_w_data_sel();
+        mpool_ptr = SpiMemPoolTxFifo[(TxFifoHead + sel) % SPI_MEM_POOL_SIZE];
+        for (i = sel; i > 0; i--) {
+                SpiMemPoolTxFifo[(TxFifoHead + i) % SPI_MEM_POOL_SIZE] =
+                        SpiMemPoolTxFifo[(TxFifoHead + i - 1) % SPI_MEM_POOL_SIZE];
+        }
+        TxFifoHead = (TxFifoHead + 1) % SPI_MEM_POOL_SIZE;
+        TxFifoCnt--;
+
+        return mpool_ptr;
+}
+
+
+
+/* the pool that get_spi_mpool_w_data would return, left in the Tx FIFO */
+spi_mpool_t* peek_spi_mpool_w_data(void) {
+        if (TxFifoCnt == 0) {
+                return NULL;
+        }
+
+        return SpiMemPoolTxFifo[(TxFifoHead + get_spi_mpool_w_data_sel()) % SPI_MEM_POOL_SIZE];
+}
+
+
+
+uint16 get_spi_mpool_tx_queued(void) {
+        return TxFifoCnt;
+}
+
+
+
+/* pools free for any use, Rx included */
+uint16 get_spi_mpool_free_cnt(void) {
+        return SPI_MEM_POOL_SIZE - get_spi_mpool_busy_cnt();
+}
+
+
+
+/* number of frames that can be given for Tx now */
+uint16 get_spi_mpool_tx_credit(void) {
+        u16 free_cnt = SPI_MEM_POOL_SIZE - get_spi_mpool_busy_cnt();
+
+        return (free_cnt > SPI_MEM_POOL_RX_RESERVE) ? (free_cnt - SPI_MEM_POOL_RX_RESERVE) : 0;
+}
+
+
+
+boolean put_spi_mpool_tx_done(spi_mpool_t* p_mpool) {
+        if (TxDoneCnt >= SPI_MEM_POOL_SIZE) {
+                return FALSE;
+        }
+
+        SpiMemPoolTxDone[(TxDoneHead + TxDoneCnt) % SPI_MEM_POOL_SIZE].idx = get_spi_mpool_idx(p_mpool);
+        SpiMemPoolTxDone[(TxDoneHead + TxDoneCnt) % SPI_MEM_POOL_SIZE].ts = p_mpool->tx_ts;
+        TxDoneCnt++;
+
+        return TRUE;
+}
+
+
+
+/* p_ts may be NULL if the egress timestamp is not needed */
+boolean get_spi_mpool_tx_done(uint32* p_idx, macphy_ts_t* p_ts) {
+        if (TxDoneCnt == 0) {
+                return FALSE;
+        }
+
+        *p_idx = SpiMemPoolTxDone[TxDoneHead].idx;
+        if (p_ts != NULL) {
+                *p_ts = SpiMemPoolTxDone[TxDoneHead].ts;
+        }
+        TxDoneHead = (TxDoneHead + 1) % SPI_MEM_POOL_SIZE;
+        TxDoneCnt--;
+
+        return TRUE;
+}
+
+
+
+spi_mpool_t* get_spi_mpool_by_idx(uint32 idx) {
+        return (idx < SPI_MEM_POOL_SIZE) ? &SpiMemPool[idx] : NULL;
+}
+
+
+
+uint32 get_spi_mpool_idx(spi_mpool_t* p_mpool) {
+        return (uint32)(p_mpool - SpiMemPool);
+}
+
+
+
+void get_spi_mpool_stats(spi_mpool_stats_t* p_stats) {
+        if (p_stats != NULL) {
+                *p_stats = SpiMemPoolStats;
+        }
+}
+
+
+
+void reset_spi_mpool_stats(void) {
+        memset(&SpiMemPoolStats, 0, sizeof(SpiMemPoolStats));
+}
@@ -24,10 +24,13 @@
 #include <Platform_Types.h>
 #include <Std_Types.h>
 #include <stddef.h>
+#include <macphy_ts.h>
 
 
 #define MEM_POOL_BUF_LEN        (1522)
 #define SPI_MEM_POOL_SIZE           (3)
+#define SPI_MEM_POOL_RX_RESERVE     (1) /* pools that Tx can't take, to keep Rx going */
+#define MEM_POOL_TX_DATA_OFS        (2) /* room for SPI opcode + per-packet control byte */
 
 
 typedef enum {
@@ -42,13 +45,52 @@ typedef struct {
         uint8 tx_buf[MEM_POOL_BUF_LEN];
         uint8 rx_buf[MEM_POOL_BUF_LEN];
         uint16 dlen;
+        uint32 seq; /* frame sequence number, used by the tracepoints */
         spi_mpool_state_t state;
+        boolean tx_confirm;
+        boolean vlan;   /* Tx: frame carries an 802.1Q tag */
+        uint8 prio;     /* Tx: higher goes first out of the Tx FIFO */
+        macphy_ts_t tx_ts; /* Tx: egress timestamp, taken by the backend */
 } spi_mpool_t;
 
 
+// Pool usage telemetry for sizing SPI_MEM_POOL_SIZE, the *_ms fields are the
+// uptime of the last time the high-water mark was reached or the event was seen
+typedef struct {
+        uint16 busy_hwm;        /* pools taken at the same time */
+        uint32 busy_hwm_ms;
+        uint16 tx_queued_hwm;   /* depth of the Tx FIFO */
+        uint32 tx_queued_hwm_ms;
+        uint32 exhausted;       /* get_new_spi_mpool found no free pool */
+        uint32 exhausted_ms;
+        uint32 tx_refused;      /* Tx found no pool outside the Rx reserve */
+        uint32 tx_refused_ms;
+} spi_mpool_stats_t;
+
+
 spi_mpool_t* get_new_spi_mpool(void);
-spi_mpool_t* get_spi_mpool_w_data(void);
+spi_mpool_t* get_new_spi_mpool_tx(void);
 boolean free_spi_mpool(spi_mpool_t* p_mpool);
+uint16 get_spi_mpool_free_cnt(void);
+
+// Tx FIFO, filled pools are sent highest prio first, in the order they are put
+boolean put_spi_mpool_w_data(spi_mpool_t* p_mpool);
+spi_mpool_t* get_spi_mpool_w_data(void);
+spi_mpool_t* peek_spi_mpool_w_data(void);
+uint16 get_spi_mpool_tx_queued(void);
+uint16 get_spi_mpool_tx_credit(void);
+
+// Tx confirmations of the sent pools, put by the backends when a frame is
+// handed over to the MACPHY (TXRTS set, or its last chunk written), not when
+// the MAC reports its transmission
+boolean put_spi_mpool_tx_done(spi_mpool_t* p_mpool);
+boolean get_spi_mpool_tx_done(uint32* p_idx, macphy_ts_t* p_ts);
+
+spi_mpool_t* get_spi_mpool_by_idx(uint32 idx);
+uint32 get_spi_mpool_idx(spi_mpool_t* p_mpool);
+
+void get_spi_mpool_stats(spi_mpool_stats_t* p_stats);
+void reset_spi_mpool_stats(void);
 
 
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Created on Mon Oct 19 2026 2:10:44 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_OPS_H
+#define MACPHY_OPS_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+#include <Eth_GeneralTypes.h>
+#include <Eth_cfg.h>
+#include <macphy_mpool.h>
+
+
+// Number of bytes of a received frame given to the Rx classifier, enough for
+// the Eth, VLAN, IPv4 (without options) and UDP headers
+#define MACPHY_RX_PREFIX_SZ     (46)
+
+// Verdict of the Rx classifier on the header prefix of a received frame
+typedef enum {
+        MACPHY_RX_DROP,         /* discard, the rest of the frame is not read */
+        MACPHY_RX_HDR_ONLY,     /* deliver the header prefix only */
+        MACPHY_RX_FULL          /* read and deliver the whole frame */
+} macphy_rx_verdict_t;
+
+typedef macphy_rx_verdict_t (*macphy_rx_classify_t)(const uint8 *hdr, uint16 hdr_len, uint16 pktlen);
+
+
+// One fragment of a gathered Tx frame
+typedef struct {
+        const uint8 *data;
+        uint16 len;
+} macphy_frag_t;
+
+#define MACPHY_MAX_FRAGS        (8)
+
+
+// Operations of a MACPHY backend, each device in EthControllerDevType has one
+// set. All Tx pools given to pkt_send / mpool_send carry the frame at
+// tx_buf+MEM_POOL_TX_DATA_OFS, so the backends can share the mpool module.
+// A backend with egress timestamps fills tx_ts of the pool before it is put
+// to the Tx confirmation FIFO.
+typedef struct {
+        const char *name;
+        boolean (*init)(const Eth_ConfigType *cfg);
+        void    (*periodic_fn)(void);
+        boolean (*pkt_send)(uint8 *pktptr, uint16 pktlen);
+        boolean (*mpool_send)(spi_mpool_t *mpool);
+        uint16  (*pkt_recv)(uint8 *pktptr, uint16 maxlen);
+        uint8   (*rx_pending)(void);
+        uint8   (*tx_credit)(void);
+        void    (*get_tx_err_counters)(Eth_TxErrorCounterValuesType *cntrs);
+        uint32  (*spi_status)(void); /* optional, NULL if the device has none */
+        void    (*set_rx_classifier)(macphy_rx_classify_t fn); /* optional */
+        void    (*irq_notify)(void);    /* optional, called from the ISR of the INT pin */
+        boolean (*rx_polling)(void);    /* optional, TRUE if Rx is polled for now */
+        boolean (*frags_send)(const macphy_frag_t *frags, uint8 nfrags); /* optional */
+        boolean (*get_rx_ts)(macphy_ts_t *ts); /* optional, of the frame from the last pkt_recv */
+        void    (*tx_service)(void);    /* optional, starts the queued frames the MAC can take now */
+} macphy_ops_t;
+
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Created on Mon Oct 19 2026 4:47:06 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "macphy_pcap.h"
+
+
+#if MACPHY_PCAP_ENABLE == 1
+macphy_pcap_buf_t MacPhyPcap;
+uint8  MacPhyPcapDirs = MACPHY_PCAP_DIR_RX | MACPHY_PCAP_DIR_TX;
+uint16 MacPhyPcapEthType; /* 0 = all */
+
+
+
+static void pcap_put32(uint8 *p, uint32 v) {
+        p[0] = (uint8)(v);
+        p[1] = (uint8)(v >> 8);
+        p[2] = (uint8)(v >> 16);
+        p[3] = (uint8)(v >> 24);
+}
+#endif
+
+
+
+void macphy_pcap_init(void) {
+#if MACPHY_PCAP_ENABLE == 1
+        MacPhyPcap.magic = MACPHY_PCAP_MAGIC;
+        MacPhyPcap.head = 0;
+        MacPhyPcap.cyc_per_sec = sys_clock_hw_cycles_per_sec();
+        MacPhyPcap.snaplen = MACPHY_PCAP_SNAPLEN;
+        MacPhyPcap.ring_size = MACPHY_PCAP_RING_SIZE;
+#endif
+}
+
+
+
+/* dirs is a mask of MACPHY_PCAP_DIR_xx, ethtype 0 captures all EtherTypes */
+void macphy_pcap_set_filter(uint8 dirs, uint16 ethtype) {
+#if MACPHY_PCAP_ENABLE == 1
+        MacPhyPcapDirs = dirs;
+        MacPhyPcapEthType = ethtype;
+#else
+        (void) dirs;
+        (void) ethtype;
+#endif
+}
+
+
+
+/* returns NULL if the capture is compiled out */
+const macphy_pcap_buf_t* macphy_pcap_get(void) {
+#if MACPHY_PCAP_ENABLE == 1
+        return &MacPhyPcap;
+#else
+        return NULL;
+#endif
+}
+
+
+
+/* Streams the ring, oldest frame first, in the pcap file format through
+** write (e.g. a UART or a shell). Time is relative to the oldest frame.
+** Returns the number of frames written. Capturing must be idle meanwhile. */
+uint32 macphy_pcap_export(macphy_pcap_write_t write) {
+#if MACPHY_PCAP_ENABLE == 1
+        const macphy_pcap_rec_t *rec;
+        uint8 hdr[24];
+        uint64 us, cyc = 0;
+        uint32 i, first, cnt, last = 0;
+
+        if (write == NULL) {
+                return 0;
+        }
+
+        /* global header: LINKTYPE_ETHERNET, micro second time stamps */
+        pcap_put32(hdr, 0xA1B2C3D4);
+        pcap_put32(hdr+4, 0x00040002); // version 2.4
+        pcap_put32(hdr+8, 0);
+        pcap_put32(hdr+12, 0);
+        pcap_put32(hdr+16, MACPHY_PCAP_SNAPLEN);
+        pcap_put32(hdr+20, 1);
+        write(hdr, 24);
+
+        cnt = (MacPhyPcap.head < MACPHY_PCAP_RING_SIZE) ? MacPhyPcap.head : MACPHY_PCAP_RING_SIZE;
+        first = MacPhyPcap.head - cnt;
+        for (i = 0; i < cnt; i++) {
+                rec = &MacPhyPcap.ring[(first + i) & (MACPHY_PCAP_RING_SIZE-1)];
+                if (i > 0) {
+                        cyc += (uint32)(rec->cycles - last); // wraps of the counter
+                }
+                last = rec->cycles;
+                us = (cyc * 1000000) / MacPhyPcap.cyc_per_sec;
+
+                pcap_put32(hdr, (uint32)(us / 1000000));
+                pcap_put32(hdr+4, (uint32)(us % 1000000));
+                pcap_put32(hdr+8, rec->caplen);
+                pcap_put32(hdr+12, rec->orig_len);
+                write(hdr, 16);
+                write(rec->data, rec->caplen);
+        }
+
+        return cnt;
+#else
+        (void) write;
+        return 0;
+#endif
+}
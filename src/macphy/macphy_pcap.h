@@ -0,0 +1,111 @@
+/*
+ * Created on Mon Oct 19 2026 4:47:06 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_PCAP_H
+#define MACPHY_PCAP_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+#include <stddef.h>
+#include <string.h>
+#include <os_api.h>
+
+
+// set this to 1 to capture the first MACPHY_PCAP_SNAPLEN bytes of the Tx and
+// Rx frames into MacPhyPcap
+#define MACPHY_PCAP_ENABLE              0
+#define MACPHY_PCAP_SNAPLEN             (64) /* must be a multiple of 8 */
+#define MACPHY_PCAP_RING_SIZE           (64) /* must be a power of 2 */
+#define MACPHY_PCAP_MAGIC               (0x5043504D) /* "MPCP" */
+
+#if (MACPHY_PCAP_SNAPLEN % 8) || (MACPHY_PCAP_SNAPLEN > 255)
+#error "MACPHY_PCAP_SNAPLEN must be a multiple of 8, below 256"
+#endif
+
+#define MACPHY_PCAP_DIR_RX              (0x01)
+#define MACPHY_PCAP_DIR_TX              (0x02)
+
+
+/* One captured frame, the layout is decoded by tools/macphy_pcapdump.py */
+typedef struct {
+        uint32 cycles;          /* k_cycle_get_32 at capture */
+        uint16 orig_len;
+        uint8  caplen;
+        uint8  dir;             /* MACPHY_PCAP_DIR_RX or MACPHY_PCAP_DIR_TX */
+        uint8  data[MACPHY_PCAP_SNAPLEN];
+} macphy_pcap_rec_t;
+
+
+/* The whole buffer is one object, so that it can be dumped by the debugger
+** with a single command, like MacPhyTrace */
+typedef struct {
+        uint32 magic;
+        uint32 head;            /* free running write index */
+        uint32 cyc_per_sec;
+        uint16 snaplen;
+        uint16 ring_size;
+        macphy_pcap_rec_t ring[MACPHY_PCAP_RING_SIZE];
+} macphy_pcap_buf_t;
+
+
+typedef void (*macphy_pcap_write_t)(const uint8 *data, uint32 len);
+
+
+#if MACPHY_PCAP_ENABLE == 1
+extern macphy_pcap_buf_t MacPhyPcap;
+extern uint8  MacPhyPcapDirs;
+extern uint16 MacPhyPcapEthType;
+
+/* Called from the MACPHY owner context only (single writer), hence the head
+** index is updated without locks. One copy of at most the snaplen, of the
+** first caplen bytes of a frame of len bytes. */
+static inline void macphy_pcap_rec_part(uint8 dir, const uint8 *frame, uint16 caplen, uint16 len) {
+        macphy_pcap_rec_t *rec;
+
+        if (((MacPhyPcapDirs & dir) == 0) || (frame == NULL) || (caplen < 14)) {
+                return;
+        }
+        if (MacPhyPcapEthType && (((frame[12] << 8) | frame[13]) != MacPhyPcapEthType)) {
+                return;
+        }
+
+        rec = &MacPhyPcap.ring[MacPhyPcap.head++ & (MACPHY_PCAP_RING_SIZE-1)];
+        rec->cycles = k_cycle_get_32();
+        rec->orig_len = len;
+        rec->caplen = (caplen < MACPHY_PCAP_SNAPLEN) ? caplen : MACPHY_PCAP_SNAPLEN;
+        rec->dir = dir;
+        memcpy(rec->data, frame, rec->caplen);
+}
+
+#define MACPHY_PCAP(dir, frame, len)    macphy_pcap_rec_part((dir), (frame), (len), (len))
+#define MACPHY_PCAP_PART(dir, frame, caplen, len) macphy_pcap_rec_part((dir), (frame), (caplen), (len))
+#else
+#define MACPHY_PCAP(dir, frame, len)
+#define MACPHY_PCAP_PART(dir, frame, caplen, len)
+#endif
+
+
+void macphy_pcap_init(void);
+void macphy_pcap_set_filter(uint8 dirs, uint16 ethtype);
+const macphy_pcap_buf_t* macphy_pcap_get(void);
+uint32 macphy_pcap_export(macphy_pcap_write_t write);
+
+
+#endif
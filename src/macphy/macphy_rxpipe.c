@@ -0,0 +1,203 @@
+/*
+ * Created on Mon Oct 19 2026 4:12:50 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <macphy.h>
+#include "macphy_rxpipe.h"
+
+
+#if (MACPHY_RX_PIPE_BUFS & (MACPHY_RX_PIPE_BUFS - 1)) || (MACPHY_RX_PIPE_BUFS > 255)
+#error "MACPHY_RX_PIPE_BUFS must be a power of 2, below 256"
+#endif
+
+// SPSC ring of buffer indices, the producer only writes head and the
+// consumer only writes tail. Each ring holds all the buffers at most.
+typedef struct {
+        uint8    idx[MACPHY_RX_PIPE_BUFS];
+        atomic_t head;
+        atomic_t tail;
+} macphy_rxpipe_ring_t;
+
+typedef struct {
+        uint8   data[MACPHY_RX_PIPE_FRAME_LEN];
+        uint16  len;
+        uint32  stamp;  /* cycle count at the end of the I/O stage */
+} macphy_rxpipe_buf_t;
+
+static macphy_rxpipe_buf_t RxPipeBufs[MACPHY_RX_PIPE_BUFS];
+static macphy_rxpipe_ring_t RxPipeFull;  /* I/O stage -> delivery stage */
+static macphy_rxpipe_ring_t RxPipeFree;  /* delivery stage -> I/O stage */
+
+// written by the I/O stage
+static uint32 RxPipeStalls;
+static uint16 RxPipePeak;
+
+// written by the delivery stage
+static uint32 RxPipeFrames;
+static uint32 RxPipeLatMin = 0xFFFFFFFF;
+static uint32 RxPipeLatMax;
+static uint64 RxPipeLatSum;
+
+
+
+static inline boolean rxpipe_put(macphy_rxpipe_ring_t *ring, uint8 idx) {
+        atomic_val_t head = atomic_get(&ring->head);
+
+        if ((head - atomic_get(&ring->tail)) >= MACPHY_RX_PIPE_BUFS) {
+                return FALSE;
+        }
+        ring->idx[head & (MACPHY_RX_PIPE_BUFS-1)] = idx;
+        atomic_set(&ring->head, head+1);
+
+        return TRUE;
+}
+
+
+
+static inline boolean rxpipe_get(macphy_rxpipe_ring_t *ring, uint8 *idx) {
+        atomic_val_t tail = atomic_get(&ring->tail);
+
+        if (tail == atomic_get(&ring->head)) {
+                return FALSE;
+        }
+        *idx = ring->idx[tail & (MACPHY_RX_PIPE_BUFS-1)];
+        atomic_set(&ring->tail, tail+1);
+
+        return TRUE;
+}
+
+
+
+/* to be called before any of the stages run, all buffers start as free */
+void macphy_rxpipe_init(void) {
+        uint8 i;
+
+        atomic_set(&RxPipeFull.head, 0);
+        atomic_set(&RxPipeFull.tail, 0);
+        atomic_set(&RxPipeFree.head, 0);
+        atomic_set(&RxPipeFree.tail, 0);
+        for (i = 0; i < MACPHY_RX_PIPE_BUFS; i++) {
+                rxpipe_put(&RxPipeFree, i);
+        }
+        macphy_rxpipe_reset_stats();
+}
+
+
+
+/* I/O stage, runs in the owner context of the MACPHY: reads up to budget
+** frames directly into free pipe buffers. Returns the frames read. */
+uint16 macphy_rxpipe_io(uint16 budget) {
+        macphy_rxpipe_buf_t *buf;
+        uint16 cnt = 0, occ;
+        uint8 idx;
+
+        /* the pending count of the backends is only updated by a read, hence
+        the MACPHY is always read first and the count only tells whether a
+        failed read has frames behind it */
+        while (cnt < budget) {
+                if (FALSE == rxpipe_get(&RxPipeFree, &idx)) {
+                        RxPipeStalls++; // delivery stage is behind
+                        break;
+                }
+
+                buf = &RxPipeBufs[idx];
+                buf->len = macphy_pkt_recv(buf->data, sizeof(buf->data));
+                if (buf->len == 0) {
+                        rxpipe_put(&RxPipeFree, idx);
+                        if (macphy_rx_pending() == 0) {
+                                break;
+                        }
+                        cnt++;
+                        continue;
+                }
+                cnt++;
+
+                buf->stamp = k_cycle_get_32();
+                rxpipe_put(&RxPipeFull, idx);
+                occ = (uint16)(atomic_get(&RxPipeFull.head) - atomic_get(&RxPipeFull.tail));
+                if (occ > RxPipePeak) {
+                        RxPipePeak = occ;
+                }
+        }
+
+        return cnt;
+}
+
+
+
+/* Delivery stage, runs on the other core: passes up to budget frames to cbk
+** and returns their buffers to the I/O stage. Returns the frames delivered. */
+uint16 macphy_rxpipe_deliver(uint16 budget, macphy_rxpipe_cbk_t cbk) {
+        macphy_rxpipe_buf_t *buf;
+        uint16 cnt = 0;
+        uint32 lat;
+        uint8 idx;
+
+        while ((cnt < budget) && rxpipe_get(&RxPipeFull, &idx)) {
+                buf = &RxPipeBufs[idx];
+                lat = k_cyc_to_us_floor32(k_cycle_get_32() - buf->stamp);
+                if (lat < RxPipeLatMin) {
+                        RxPipeLatMin = lat;
+                }
+                if (lat > RxPipeLatMax) {
+                        RxPipeLatMax = lat;
+                }
+                RxPipeLatSum += lat;
+                RxPipeFrames++;
+
+                if (cbk) {
+                        cbk(buf->data, buf->len);
+                }
+                rxpipe_put(&RxPipeFree, idx);
+                cnt++;
+        }
+
+        return cnt;
+}
+
+
+
+void macphy_rxpipe_get_stats(macphy_rxpipe_stats_t *stats) {
+        if (stats == NULL) {
+                return;
+        }
+
+        stats->frames = RxPipeFrames;
+        stats->io_stalls = RxPipeStalls;
+        stats->lat_min_us = (RxPipeFrames) ? RxPipeLatMin : 0;
+        stats->lat_max_us = RxPipeLatMax;
+        stats->lat_avg_us = (RxPipeFrames) ? (uint32)(RxPipeLatSum / RxPipeFrames) : 0;
+        stats->occupancy = (uint16)(atomic_get(&RxPipeFull.head) - atomic_get(&RxPipeFull.tail));
+        stats->peak_occupancy = RxPipePeak;
+}
+
+
+
+void macphy_rxpipe_reset_stats(void) {
+        RxPipeStalls = 0;
+        RxPipePeak = 0;
+        RxPipeFrames = 0;
+        RxPipeLatMin = 0xFFFFFFFF;
+        RxPipeLatMax = 0;
+        RxPipeLatSum = 0;
+}
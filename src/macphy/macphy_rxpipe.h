@@ -0,0 +1,64 @@
+/*
+ * Created on Mon Oct 19 2026 4:12:50 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_RXPIPE_H
+#define MACPHY_RXPIPE_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+
+
+// Pipelined Rx for dual core parts: the I/O stage (macphy_rxpipe_io) only
+// reads frames from the MACPHY into the pipe buffers, and the delivery stage
+// (macphy_rxpipe_deliver) hands them to the upper layer on the other core.
+// Filled buffers go over one SPSC ring and come back over a return ring, so
+// frames are not copied between the stages.
+//
+// With MACPHY_RX_PIPE_ENABLE the Rx drain of Eth_MainFunction runs the I/O
+// stage in place of Eth_Receive, and a thread on the other core runs the
+// delivery stage with Eth_RxPipeDeliver, which indicates the frames to the
+// upper layer. Eth_Receive must not be called then, and the piped frames have
+// no ingress timestamp.
+#define MACPHY_RX_PIPE_ENABLE           0
+#define MACPHY_RX_PIPE_BUFS             (4) /* must be a power of 2 */
+#define MACPHY_RX_PIPE_FRAME_LEN        (1518)
+
+
+typedef void (*macphy_rxpipe_cbk_t)(uint8 *frame, uint16 len);
+
+typedef struct {
+        uint32  frames;
+        uint32  io_stalls;      /* I/O stage found no free buffer */
+        uint32  lat_min_us;     /* handoff latency, I/O done -> delivery start */
+        uint32  lat_max_us;
+        uint32  lat_avg_us;
+        uint16  occupancy;      /* frames waiting for delivery now */
+        uint16  peak_occupancy;
+} macphy_rxpipe_stats_t;
+
+
+void    macphy_rxpipe_init(void);
+uint16  macphy_rxpipe_io(uint16 budget);
+uint16  macphy_rxpipe_deliver(uint16 budget, macphy_rxpipe_cbk_t cbk);
+void    macphy_rxpipe_get_stats(macphy_rxpipe_stats_t *stats);
+void    macphy_rxpipe_reset_stats(void);
+
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Created on Mon Oct 19 2026 3:41:18 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <string.h>
+#include <zephyr/sys/atomic.h>
+
+#include <macphy.h>
+#include "macphy_rxsteer.h"
+
+
+#if (MACPHY_RX_STEER_DEPTH & (MACPHY_RX_STEER_DEPTH - 1))
+#error "MACPHY_RX_STEER_DEPTH must be a power of 2"
+#endif
+
+// Single producer (the owner context) single consumer ring. The producer
+// only writes head and the consumer only writes tail, the atomics order the
+// frame data against the index updates.
+typedef struct {
+        uint8   buf[MACPHY_RX_STEER_DEPTH][MACPHY_RX_STEER_FRAME_LEN];
+        uint16  len[MACPHY_RX_STEER_DEPTH];
+        atomic_t head;
+        atomic_t tail;
+} macphy_rx_ring_t;
+
+static macphy_rx_ring_t RxRings[MACPHY_RX_STEER_RINGS];
+static uint8 RxSteerBuf[MACPHY_RX_STEER_FRAME_LEN];
+static uint32 RxSteerEnq[MACPHY_RX_STEER_RINGS];
+static uint32 RxSteerDrop[MACPHY_RX_STEER_RINGS];
+static uint16 RxSteerPeak[MACPHY_RX_STEER_RINGS];
+
+
+
+static inline uint32 fnv1a(uint32 h, const uint8 *p, uint16 len) {
+        while (len--) {
+                h ^= *p++;
+                h *= 16777619u;
+        }
+
+        return h;
+}
+
+
+
+void macphy_rxsteer_init(void) {
+        uint8 r;
+
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                atomic_set(&RxRings[r].head, 0);
+                atomic_set(&RxRings[r].tail, 0);
+                RxSteerEnq[r] = 0;
+                RxSteerDrop[r] = 0;
+                RxSteerPeak[r] = 0;
+        }
+}
+
+
+
+/* Hashes the MACs, EtherType and VLAN ID, plus the IPv4 addresses, protocol
+** and TCP / UDP ports when present, into a ring index */
+uint8 macphy_rxsteer_hash(const uint8 *frame, uint16 len) {
+        uint32 h = 2166136261u;
+        uint16 ofs = 12, ethtype, ihl;
+
+        if ((frame == NULL) || (len < 14)) {
+                return 0;
+        }
+
+        h = fnv1a(h, frame, 12);
+        ethtype = (frame[ofs] << 8) | frame[ofs+1];
+        if ((ethtype == 0x8100) && (len >= 18)) {
+                h = fnv1a(h, frame+14, 2); // VLAN ID, not the priority
+                ofs += 4;
+                ethtype = (frame[ofs] << 8) | frame[ofs+1];
+        }
+        h = fnv1a(h, frame+ofs, 2);
+        ofs += 2;
+
+        /* IPv4 5-tuple, the ports only in the first fragment */
+        if ((ethtype == 0x0800) && (len >= ofs+20) && ((frame[ofs] >> 4) == 4)) {
+                ihl = (frame[ofs] & 0x0F) * 4;
+                h = fnv1a(h, frame+ofs+9, 1);
+                h = fnv1a(h, frame+ofs+12, 8);
+                if (((frame[ofs+9] == 6) || (frame[ofs+9] == 17)) &&
+                        (((frame[ofs+6] & 0x1F) | frame[ofs+7]) == 0) && (len >= ofs+ihl+4)) {
+                        h = fnv1a(h, frame+ofs+ihl, 4);
+                }
+        }
+
+        return (uint8)(h % MACPHY_RX_STEER_RINGS);
+}
+
+
+
+/* Owner context only: reads up to budget frames from the MACPHY and puts each
+** into the ring of its flow. Returns the number of frames read. */
+uint16 macphy_rxsteer_poll(uint16 budget) {
+        macphy_rx_ring_t *ring;
+        uint16 cnt = 0, len, depth;
+        atomic_val_t head;
+        uint8 r;
+
+        /* the pending count of the backends is only updated by a read, hence
+        the MACPHY is always read first and the count only tells whether a
+        failed read has frames behind it */
+        while (cnt < budget) {
+                len = macphy_pkt_recv(RxSteerBuf, sizeof(RxSteerBuf));
+                if ((len == 0) && (macphy_rx_pending() == 0)) {
+                        break;
+                }
+                cnt++;
+                if (len == 0) {
+                        continue;
+                }
+
+                r = macphy_rxsteer_hash(RxSteerBuf, len);
+                ring = &RxRings[r];
+                head = atomic_get(&ring->head);
+                depth = (uint16)(head - atomic_get(&ring->tail));
+                if (depth >= MACPHY_RX_STEER_DEPTH) {
+                        RxSteerDrop[r]++;
+                        continue;
+                }
+
+                memcpy(ring->buf[head & (MACPHY_RX_STEER_DEPTH-1)], RxSteerBuf, len);
+                ring->len[head & (MACPHY_RX_STEER_DEPTH-1)] = len;
+                atomic_set(&ring->head, head+1);
+                RxSteerEnq[r]++;
+                if (depth+1 > RxSteerPeak[r]) {
+                        RxSteerPeak[r] = depth+1;
+                }
+        }
+
+        return cnt;
+}
+
+
+
+/* Consumer of a ring: copies its oldest frame to pktptr. Returns the length,
+** 0 if the ring is empty. Frames longer than maxlen are truncated. */
+uint16 macphy_rxsteer_get(uint8 ring_idx, uint8 *pktptr, uint16 maxlen) {
+        macphy_rx_ring_t *ring;
+        atomic_val_t tail;
+        uint16 len;
+
+        if ((ring_idx >= MACPHY_RX_STEER_RINGS) || (pktptr == NULL)) {
+                return 0;
+        }
+        ring = &RxRings[ring_idx];
+
+        tail = atomic_get(&ring->tail);
+        if (tail == atomic_get(&ring->head)) {
+                return 0;
+        }
+
+        len = ring->len[tail & (MACPHY_RX_STEER_DEPTH-1)];
+        if (len > maxlen) {
+                len = maxlen;
+        }
+        memcpy(pktptr, ring->buf[tail & (MACPHY_RX_STEER_DEPTH-1)], len);
+        atomic_set(&ring->tail, tail+1);
+
+        return len;
+}
+
+
+
+void macphy_rxsteer_get_stats(macphy_rxsteer_stats_t *stats) {
+        uint32 total = 0, max = 0;
+        uint8 r;
+
+        if (stats == NULL) {
+                return;
+        }
+
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                stats->enqueued[r] = RxSteerEnq[r];
+                stats->dropped[r] = RxSteerDrop[r];
+                stats->depth[r] = (uint16)(atomic_get(&RxRings[r].head) - atomic_get(&RxRings[r].tail));
+                stats->peak_depth[r] = RxSteerPeak[r];
+                total += RxSteerEnq[r];
+                if (RxSteerEnq[r] > max) {
+                        max = RxSteerEnq[r];
+                }
+        }
+
+        /* 0 if all rings got the same share, 100 * (N-1) if one got all */
+        stats->imbalance_pct = (total == 0) ? 0 :
+                (uint16)((max * 100 * MACPHY_RX_STEER_RINGS) / total - 100);
+}
@@ -0,0 +1,54 @@
+/*
+ * Created on Mon Oct 19 2026 3:41:18 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_RXSTEER_H
+#define MACPHY_RXSTEER_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+
+
+// Rx flow steering: the owner context reads the frames from the MACPHY with
+// macphy_rxsteer_poll (instead of Eth_Receive) and spreads them over the Rx
+// rings by a hash of the flow key, one consumer thread per ring takes them
+// with macphy_rxsteer_get. Frames of a flow always go to the same ring, so
+// their order is kept.
+#define MACPHY_RX_STEER_RINGS           (2)
+#define MACPHY_RX_STEER_DEPTH           (4) /* must be a power of 2 */
+#define MACPHY_RX_STEER_FRAME_LEN       (1518)
+
+
+typedef struct {
+        uint32  enqueued[MACPHY_RX_STEER_RINGS];
+        uint32  dropped[MACPHY_RX_STEER_RINGS];    /* ring was full */
+        uint16  depth[MACPHY_RX_STEER_RINGS];      /* frames in the ring now */
+        uint16  peak_depth[MACPHY_RX_STEER_RINGS];
+        uint16  imbalance_pct;  /* busiest ring vs. the mean, in % above it */
+} macphy_rxsteer_stats_t;
+
+
+void    macphy_rxsteer_init(void);
+uint8   macphy_rxsteer_hash(const uint8 *frame, uint16 len);
+uint16  macphy_rxsteer_poll(uint16 budget);
+uint16  macphy_rxsteer_get(uint8 ring, uint8 *pktptr, uint16 maxlen);
+void    macphy_rxsteer_get_stats(macphy_rxsteer_stats_t *stats);
+
+
+#endif
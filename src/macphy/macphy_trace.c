@@ -0,0 +1,48 @@
+/*
+ * Created on Mon Oct 19 2026 9:12:40 AM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "macphy_trace.h"
+
+
+#if MACPHY_TRACE_ENABLE == 1
+macphy_trace_buf_t MacPhyTrace;
+#endif
+
+
+
+void macphy_trace_init(void) {
+#if MACPHY_TRACE_ENABLE == 1
+        MacPhyTrace.magic = MACPHY_TRACE_MAGIC;
+        atomic_set(&MacPhyTrace.head, 0);
+        MacPhyTrace.cyc_per_sec = sys_clock_hw_cycles_per_sec();
+#endif
+}
+
+
+
+/* returns NULL if the tracing is compiled out */
+const macphy_trace_buf_t* macphy_trace_get(void) {
+#if MACPHY_TRACE_ENABLE == 1
+        return &MacPhyTrace;
+#else
+        return NULL;
+#endif
+}
@@ -0,0 +1,93 @@
+/*
+ * Created on Mon Oct 19 2026 9:12:40 AM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_TRACE_H
+#define MACPHY_TRACE_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+#include <stddef.h>
+#include <os_api.h>
+#include <zephyr/sys/atomic.h>
+
+
+// set this to 1 to record per-frame timing events into MacPhyTrace
+#define MACPHY_TRACE_ENABLE             0
+#define MACPHY_TRACE_RING_SIZE          (256) /* must be a power of 2 */
+#define MACPHY_TRACE_MAGIC              (0x4352544D) /* "MTRC" */
+
+
+typedef enum {
+        TRC_TX_BUF_PROVIDED,
+        TRC_TX_SPI_WR_START,
+        TRC_TX_SPI_WR_DONE,
+        TRC_TX_TXRTS_SET,
+        TRC_TX_COMPLETE,
+        TRC_RX_PKTCNT_SEEN,
+        TRC_RX_HDR_READ,
+        TRC_RX_PAYLOAD_READ,
+        TRC_RX_DELIVERED,
+        MAX_TRC_EVENT
+} macphy_trc_evt_t;
+
+
+/* One trace record, written with a single 64-bit store:
+** bits[31:0]  - cycle counter (k_cycle_get_32)
+** bits[55:32] - frame sequence number
+** bits[63:56] - event (macphy_trc_evt_t) */
+typedef uint64 macphy_trace_t;
+
+
+/* The whole buffer is one object, so that it can be dumped by the debugger
+** with a single command and converted by tools/macphy_trace2json.py */
+typedef struct {
+        uint32 magic;
+        atomic_t head; /* free running write index, 32 bit on the targets */
+        uint32 cyc_per_sec;
+        uint32 reserved;
+        macphy_trace_t ring[MACPHY_TRACE_RING_SIZE];
+} macphy_trace_buf_t;
+
+
+
+#if MACPHY_TRACE_ENABLE == 1
+extern macphy_trace_buf_t MacPhyTrace;
+
+/* TRC_TX_BUF_PROVIDED is recorded in the context of the caller of the Tx
+** APIs, the others in the driver context, hence each writer takes its slot
+** with an atomic increment of the head. */
+static inline void macphy_trace_rec(macphy_trc_evt_t evt, uint32 seq) {
+        uint32 idx = (uint32) atomic_inc(&MacPhyTrace.head) & (MACPHY_TRACE_RING_SIZE-1);
+
+        MacPhyTrace.ring[idx] = ((uint64)evt << 56) | ((uint64)(seq & 0xFFFFFF) << 32) |
+                k_cycle_get_32();
+}
+
+#define MACPHY_TRACE(evt, seq)  macphy_trace_rec((evt), (seq))
+#else
+#define MACPHY_TRACE(evt, seq)
+#endif
+
+
+void macphy_trace_init(void);
+const macphy_trace_buf_t* macphy_trace_get(void);
+
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Created on Mon Oct 19 2026 3:05:12 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <os_api.h>
+
+#include "macphy_ts.h"
+
+
+// 64 bit extension of k_cycle_get_32, updated from the owner context only.
+// macphy_ts_now_ns runs on every macphy_periodic_fn, far more often than the
+// 32 bit counter wraps.
+static uint64 TsCycBase;
+static uint32 TsCycLast;
+
+
+
+static uint64 macphy_ts_now_cyc(void) {
+        uint32 now = k_cycle_get_32();
+
+        TsCycBase += (uint32)(now - TsCycLast);
+        TsCycLast = now;
+
+        return TsCycBase;
+}
+
+
+
+/* nano seconds since boot, on the same time base as the frame timestamps */
+uint64 macphy_ts_now_ns(void) {
+        return k_cyc_to_ns_floor64(macphy_ts_now_cyc());
+}
+
+
+
+/* Converts a capture to nano seconds since boot. The capture must be younger
+** than one wrap of the cycle counter, i.e., it is to be converted in the Rx
+** indication or Tx confirmation of its frame. */
+boolean macphy_ts_to_ns(const macphy_ts_t *ts, uint64 *ns, uint32 *err_ns) {
+        uint64 cyc, err;
+
+        if ((ts == NULL) || (ns == NULL) || (err_ns == NULL) || (ts->valid == FALSE)) {
+                return FALSE;
+        }
+
+        cyc = macphy_ts_now_cyc() - (uint32)(TsCycLast - ts->cyc);
+        *ns = k_cyc_to_ns_floor64(cyc) - ts->ofs_ns;
+        err = k_cyc_to_ns_ceil64(ts->err_cyc);
+        *err_ns = (err > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32) err;
+
+        return TRUE;
+}
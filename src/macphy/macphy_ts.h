@@ -0,0 +1,54 @@
+/*
+ * Created on Mon Oct 19 2026 3:05:12 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_TS_H
+#define MACPHY_TS_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+#include <stddef.h>
+#include <os_api.h>
+
+
+// Software timestamps for MACPHYs without a PTP clock. A capture is a single
+// k_cycle_get_32 read; it is turned into time since boot in the owner context
+// with a 64 bit extension of the cycle counter. The event (the SFD of the
+// frame on the wire) is within err_cyc cycles before cyc - ofs_ns.
+typedef struct {
+        uint32  cyc;
+        uint32  err_cyc;        /* width of the capture window */
+        sint32  ofs_ns;         /* wire time from the SFD to the capture */
+        boolean valid;
+} macphy_ts_t;
+
+
+static inline void macphy_ts_capture(macphy_ts_t *ts, uint32 win_start, sint32 ofs_ns) {
+        ts->cyc = k_cycle_get_32();
+        ts->err_cyc = ts->cyc - win_start;
+        ts->ofs_ns = ofs_ns;
+        ts->valid = TRUE;
+}
+
+
+uint64  macphy_ts_now_ns(void);
+boolean macphy_ts_to_ns(const macphy_ts_t *ts, uint64 *ns, uint32 *err_ns);
+
+
+#endif
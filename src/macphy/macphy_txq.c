@@ -0,0 +1,123 @@
+/*
+ * Created on Mon Oct 19 2026 3:05:41 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "macphy_txq.h"
+
+
+// Bounded multi-producer single-consumer ring. A producer claims a slot by
+// moving TxQTail with a CAS and publishes it by writing the slot sequence.
+// The consumer takes a slot once its sequence says it is published, and
+// hands it back to the producers one lap (MACPHY_TXQ_SIZE) later.
+typedef struct {
+        atomic_t seq;
+        spi_mpool_t *mpool;
+} macphy_txq_slot_t;
+
+static macphy_txq_slot_t TxQ[MACPHY_TXQ_SIZE];
+static atomic_t TxQTail;        /* next slot for the producers */
+static uint32 TxQHead;          /* next slot for the consumer */
+static k_tid_t TxQOwner;        /* the consumer thread, NULL until it runs */
+
+
+
+void macphy_txq_init(void) {
+        uint32 i;
+
+        for (i = 0; i < MACPHY_TXQ_SIZE; i++) {
+                TxQ[i].mpool = NULL;
+                atomic_set(&TxQ[i].seq, i);
+        }
+        TxQHead = 0;
+        atomic_set(&TxQTail, 0);
+        TxQOwner = NULL;
+}
+
+
+
+/* The first caller becomes the owner, i.e., the thread of macphy_periodic_fn */
+void macphy_txq_set_owner(void) {
+        if (TxQOwner == NULL) {
+                TxQOwner = k_current_get();
+        }
+}
+
+
+
+/* TRUE if the caller may access the MACPHY. Any thread may with
+** MACPHY_TX_OWNER at 0, as may the init before the owner has run. */
+boolean macphy_txq_is_owner(void) {
+#if MACPHY_TX_OWNER == 1
+        return ((TxQOwner == NULL) || (TxQOwner == k_current_get())) ? TRUE : FALSE;
+#else
+        return TRUE;
+#endif
+}
+
+
+
+/* Lock-free, can be called from any task or ISR. Returns FALSE if full. */
+boolean macphy_txq_put(spi_mpool_t *mpool) {
+        macphy_txq_slot_t *slot;
+        atomic_val_t pos;
+        sint32 diff;
+
+        for (;;) {
+                pos = atomic_get(&TxQTail);
+                slot = &TxQ[pos & (MACPHY_TXQ_SIZE-1)];
+                diff = (sint32)(atomic_get(&slot->seq) - pos);
+                if (diff == 0) {
+                        if (atomic_cas(&TxQTail, pos, pos+1)) {
+                                break;
+                        }
+                }
+                else if (diff < 0) {
+                        return FALSE; // the consumer has not freed this slot yet
+                }
+                /* else another producer took the slot, retry */
+        }
+
+        slot->mpool = mpool;
+        atomic_set(&slot->seq, pos+1);
+
+        return TRUE;
+}
+
+
+
+/* Only for the owner context. Returns NULL if empty, or if the oldest slot
+** is claimed but not yet published by its producer. */
+spi_mpool_t* macphy_txq_get(void) {
+        macphy_txq_slot_t *slot = &TxQ[TxQHead & (MACPHY_TXQ_SIZE-1)];
+        spi_mpool_t *mpool;
+
+        if ((sint32)(atomic_get(&slot->seq) - (atomic_val_t)(TxQHead+1)) < 0) {
+                return NULL;
+        }
+
+        mpool = slot->mpool;
+        atomic_set(&slot->seq, TxQHead + MACPHY_TXQ_SIZE);
+        TxQHead++;
+
+        return mpool;
+}
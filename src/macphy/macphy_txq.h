@@ -0,0 +1,49 @@
+/*
+ * Created on Mon Oct 19 2026 3:05:41 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef MACPHY_TXQ_H
+#define MACPHY_TXQ_H
+
+#include <Platform_Types.h>
+#include <Std_Types.h>
+#include <macphy_mpool.h>
+
+
+// Tx submission queue: any task or ISR can put filled Tx pools, only the
+// driver owner context (macphy_periodic_fn) takes them out and does the SPI.
+// The owner is the thread that calls Eth_MainFunction. With 1 it must wait in
+// macphy_wait_event between the runs (see there), else a queued frame waits
+// for the next Eth_MainFunction period. 0 sends from the caller's context.
+#define MACPHY_TX_OWNER         0
+#define MACPHY_TXQ_SIZE         (4) /* must be a power of 2 */
+
+#if (MACPHY_TXQ_SIZE & (MACPHY_TXQ_SIZE - 1)) || (MACPHY_TXQ_SIZE < SPI_MEM_POOL_SIZE)
+#error "MACPHY_TXQ_SIZE must be a power of 2 and hold all of the pools"
+#endif
+
+
+void macphy_txq_init(void);
+boolean macphy_txq_put(spi_mpool_t *mpool);
+spi_mpool_t* macphy_txq_get(void);
+void macphy_txq_set_owner(void);
+boolean macphy_txq_is_owner(void);
+
+
+#endif
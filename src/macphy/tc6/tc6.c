@@ -0,0 +1,829 @@
+/*
+ * Created on Mon Oct 19 2026 2:31:17 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Spi.h>
+#include <os_api.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#include <Eth.h>
+#include "tc6.h"
+#include <macphy_mpool.h>
+#include <macphy_trace.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(tc6, LOG_LEVEL_DBG);
+
+
+// data chunks exchanged per SPI transfer, each is 4 byte header / footer + payload
+#define TC6_MAX_CHUNKS_PER_XFER         8
+#define TC6_MAX_PAYLOAD_SZ              64
+#define TC6_HDR_SZ                      4
+
+// data transfers per service call, so that a cut-through frame is not starved
+#define TC6_MAX_XFERS_PER_CALL          4
+
+// control transactions carry at most this many registers
+#define TC6_MAX_CTRL_REGS               4
+
+// number of STATUS0 polls for the reset to complete, 10 us apart
+#define TC6_RESET_POLL_CNT              100
+
+#define TC6_FCS_LEN                     (4)
+#define TC6_MIN_FRAME_LEN               (14 + TC6_FCS_LEN)
+#define TC6_RX_FRAMES                   (SPI_MEM_POOL_SIZE)
+
+// the control transactions use the same buffers, these are much shorter
+#define TC6_XFER_BUF_SZ         (TC6_MAX_CHUNKS_PER_XFER * (TC6_HDR_SZ + TC6_MAX_PAYLOAD_SZ))
+
+
+static const Eth_ConfigType *Tc6Cfg;
+static uint16  Tc6PayloadSz;    /* chunk payload size, from spi_cfg.pay_ld_size */
+static boolean Tc6Prote;        /* control data protection is on */
+static boolean Tc6SeqBit;
+static boolean Tc6NeedsConfig;  /* SYNC was lost, MACPHY has to be configured again */
+static boolean Tc6ExstPending;  /* a footer asked us to read STATUS0 */
+static tc6_stats_t Tc6Stats;
+static Eth_TxErrorCounterValuesType Tc6TxErrCounters;
+
+// Tx frame that is being sent chunk by chunk, and the frames to be sent again
+// (ahead of the Tx FIFO) after a failed transfer or a bad header
+static spi_mpool_t *Tc6TxFrame;
+static uint16 Tc6TxOfs;
+static spi_mpool_t *Tc6TxRetry[SPI_MEM_POOL_SIZE];
+static uint16 Tc6TxRetryCnt;
+
+// Rx frame that is being assembled and the frames that are ready for the host
+static spi_mpool_t *Tc6RxFrame;
+static spi_mpool_t *Tc6RxDone[TC6_RX_FRAMES];
+static uint16 Tc6RxDoneHead, Tc6RxDoneCnt;
+static uint32 Tc6RxSeq;
+
+static uint8 Tc6SpiTx[TC6_XFER_BUF_SZ];
+static uint8 Tc6SpiRx[TC6_XFER_BUF_SZ];
+
+
+
+//////////////////////////////////////////////
+// Local Functions
+static inline void tc6_put_be32(uint8 *p, uint32 v) {
+        p[0] = (uint8)(v >> 24);
+        p[1] = (uint8)(v >> 16);
+        p[2] = (uint8)(v >> 8);
+        p[3] = (uint8)(v);
+}
+
+
+static inline uint32 tc6_get_be32(const uint8 *p) {
+        return ((uint32)p[0] << 24) | ((uint32)p[1] << 16) | ((uint32)p[2] << 8) | p[3];
+}
+
+
+/* returns 1 if the number of bits set in v is odd */
+static inline uint32 tc6_odd_bits(uint32 v) {
+        v ^= v >> 16;
+        v ^= v >> 8;
+        v ^= v >> 4;
+        v ^= v >> 2;
+        v ^= v >> 1;
+        return v & 1;
+}
+
+
+/* sets the P bit, so that the header has odd parity */
+static inline uint32 tc6_add_parity(uint32 hdr) {
+        hdr &= ~TC6_HDR_P;
+        return hdr | (tc6_odd_bits(hdr) ? 0 : TC6_HDR_P);
+}
+
+
+
+static Std_ReturnType tc6_spi_xfer(uint16 len) {
+        Spi_SetupEB(0, Tc6SpiTx, Tc6SpiRx, len);
+        return Spi_SyncTransmit(Tc6Cfg->spi_cfg.spisequence);
+}
+
+
+
+/* Control transaction: header, then cnt register words (each followed by its
+** complement if protected). MISO lags MOSI by one word and echoes the header. */
+static boolean tc6_ctrl_xfer(boolean write, uint8 mms, uint16 addr, uint32 *data, uint8 cnt) {
+        uint32 hdr, echo, word;
+        uint16 wsz, len, i, o;
+
+        if ((cnt == 0) || (cnt > TC6_MAX_CTRL_REGS) || (data == NULL)) {
+                return FALSE;
+        }
+
+        wsz = Tc6Prote ? 8 : 4;
+        len = TC6_HDR_SZ + (cnt * wsz) + TC6_HDR_SZ;
+
+        hdr = (write ? TC6_CTL_WNR : 0) | ((uint32)(mms & 0x0F) << TC6_CTL_MMS_SHIFT) |
+                ((uint32)addr << TC6_CTL_ADDR_SHIFT) | ((uint32)(cnt - 1) << TC6_CTL_LEN_SHIFT);
+        hdr = tc6_add_parity(hdr);
+
+        memset(Tc6SpiTx, 0, len);
+        tc6_put_be32(Tc6SpiTx, hdr);
+        if (write) {
+                for (i = 0, o = TC6_HDR_SZ; i < cnt; i++, o += wsz) {
+                        tc6_put_be32(Tc6SpiTx+o, data[i]);
+                        if (Tc6Prote) {
+                                tc6_put_be32(Tc6SpiTx+o+4, ~data[i]);
+                        }
+                }
+        }
+
+        if (tc6_spi_xfer(len) != E_OK) {
+                return FALSE;
+        }
+
+        echo = tc6_get_be32(Tc6SpiRx+TC6_HDR_SZ);
+        if ((echo & TC6_CTL_HDRB) || (echo != hdr)) {
+                LOG_ERR("%s(): bad echo 0x%08x for header 0x%08x", __func__, echo, hdr);
+                Tc6Stats.ctrl_errors++;
+                return FALSE;
+        }
+
+        if (!write) {
+                for (i = 0, o = 2 * TC6_HDR_SZ; i < cnt; i++, o += wsz) {
+                        word = tc6_get_be32(Tc6SpiRx+o);
+                        if (Tc6Prote && (tc6_get_be32(Tc6SpiRx+o+4) != ~word)) {
+                                Tc6Stats.ctrl_errors++;
+                                return FALSE;
+                        }
+                        data[i] = word;
+                }
+        }
+
+        return TRUE;
+}
+
+
+
+static void tc6_rx_start(void) {
+        if (Tc6RxFrame != NULL) {
+                /* previous frame had no end, the MACPHY dropped the rest */
+                Tc6Stats.rx_dropped++;
+                Tc6RxFrame->dlen = 0;
+                return;
+        }
+
+        Tc6RxFrame = get_new_spi_mpool();
+        if (Tc6RxFrame == NULL) {
+                Tc6Stats.rx_dropped++;
+                return;
+        }
+        Tc6RxFrame->dlen = 0;
+        Tc6RxFrame->seq = Tc6RxSeq++;
+        MACPHY_TRACE(TRC_RX_HDR_READ, Tc6RxFrame->seq);
+}
+
+
+static void tc6_rx_drop(void) {
+        if (Tc6RxFrame != NULL) {
+                free_spi_mpool(Tc6RxFrame);
+                Tc6RxFrame = NULL;
+                Tc6Stats.rx_dropped++;
+        }
+}
+
+
+static void tc6_rx_append(const uint8 *data, uint16 len) {
+        if (Tc6RxFrame == NULL) {
+                return; /* no mpool for this frame, the data is discarded */
+        }
+
+        if (Tc6RxFrame->dlen + len > MEM_POOL_BUF_LEN) {
+                tc6_rx_drop();
+                return;
+        }
+        memcpy(Tc6RxFrame->rx_buf + Tc6RxFrame->dlen, data, len);
+        Tc6RxFrame->dlen += len;
+}
+
+
+static void tc6_rx_end(boolean frame_drop) {
+        if (Tc6RxFrame == NULL) {
+                return;
+        }
+
+        if (frame_drop || (Tc6RxFrame->dlen < TC6_MIN_FRAME_LEN) || (Tc6RxDoneCnt >= TC6_RX_FRAMES)) {
+                tc6_rx_drop();
+                return;
+        }
+
+        Tc6RxFrame->dlen -= TC6_FCS_LEN; // MACPHY has verified the FCS
+        MACPHY_TRACE(TRC_RX_PAYLOAD_READ, Tc6RxFrame->seq);
+        Tc6RxDone[(Tc6RxDoneHead + Tc6RxDoneCnt) % TC6_RX_FRAMES] = Tc6RxFrame;
+        Tc6RxDoneCnt++;
+        Tc6RxFrame = NULL;
+        Tc6Stats.rx_frames++;
+}
+
+
+
+/* Parses the Rx part of a data chunk, a chunk may end a frame and start the
+** next one (EV with an end before SWO), or hold a complete small frame. */
+static void tc6_rx_chunk(const uint8 *payload, uint32 ftr) {
+        uint16 swo, ebo;
+        boolean fd;
+
+        swo = ((ftr >> TC6_FTR_SWO_SHIFT) & TC6_FTR_SWO_MASK) * 4;
+        ebo = (ftr >> TC6_FTR_EBO_SHIFT) & TC6_FTR_EBO_MASK;
+        fd = (ftr & TC6_FTR_FD) ? TRUE : FALSE;
+        Tc6Stats.rx_chunks++;
+
+        if ((ftr & TC6_FTR_SV) && (ftr & TC6_FTR_EV) && (ebo < swo)) {
+                tc6_rx_append(payload, ebo + 1);
+                tc6_rx_end(fd);
+                tc6_rx_start();
+                tc6_rx_append(payload + swo, Tc6PayloadSz - swo);
+                return;
+        }
+
+        if (ftr & TC6_FTR_SV) {
+                tc6_rx_start();
+        }
+        else {
+                swo = 0;
+        }
+
+        if (ftr & TC6_FTR_EV) {
+                tc6_rx_append(payload + swo, ebo + 1 - swo);
+                tc6_rx_end(fd);
+        }
+        else {
+                tc6_rx_append(payload + swo, Tc6PayloadSz - swo);
+        }
+}
+
+
+
+static inline boolean tc6_tx_pending(void) {
+        return ((Tc6TxFrame != NULL) || (Tc6TxRetryCnt > 0) || (get_spi_mpool_tx_queued() > 0)) ?
+                TRUE : FALSE;
+}
+
+
+
+/* Builds the Tx part of a data chunk from the current Tx frame. Returns the
+** frame if this chunk carries its end, so that it can be completed once the
+** transfer is done. */
+static spi_mpool_t* tc6_tx_chunk(uint8 *chunk, uint32 *hdr) {
+        spi_mpool_t *frame;
+        uint16 left;
+
+        if (Tc6TxFrame == NULL) {
+                if (Tc6TxRetryCnt > 0) {
+                        Tc6TxFrame = Tc6TxRetry[0];
+                        Tc6TxRetryCnt--;
+                        memmove(Tc6TxRetry, Tc6TxRetry+1, Tc6TxRetryCnt * sizeof(Tc6TxRetry[0]));
+                }
+                else {
+                        Tc6TxFrame = get_spi_mpool_w_data();
+                }
+                if (Tc6TxFrame == NULL) {
+                        return NULL;
+                }
+                Tc6TxOfs = 0;
+                *hdr |= TC6_HDR_SV; // SWO = 0, frames start at the chunk start
+                MACPHY_TRACE(TRC_TX_SPI_WR_START, Tc6TxFrame->seq);
+        }
+        frame = Tc6TxFrame;
+
+        left = frame->dlen - Tc6TxOfs;
+        if (left > Tc6PayloadSz) {
+                left = Tc6PayloadSz;
+        }
+        else {
+                *hdr |= TC6_HDR_EV | ((uint32)(left - 1) << TC6_HDR_EBO_SHIFT);
+                Tc6TxFrame = NULL;
+        }
+
+        memcpy(chunk + TC6_HDR_SZ, frame->tx_buf + MEM_POOL_TX_DATA_OFS + Tc6TxOfs, left);
+        Tc6TxOfs += left;
+        *hdr |= TC6_HDR_DV;
+        Tc6Stats.tx_chunks++;
+
+        return (Tc6TxFrame == NULL) ? frame : NULL;
+}
+
+
+
+static boolean tc6_frame_in(spi_mpool_t **frames, uint16 cnt, const spi_mpool_t *frame) {
+        uint16 i;
+
+        for (i = 0; i < cnt; i++) {
+                if (frames[i] == frame) {
+                        return TRUE;
+                }
+        }
+
+        return FALSE;
+}
+
+
+
+/* The MACPHY drops the frame in progress if it did not take a chunk, due to a
+** bad header or a failed transfer. Such frames are sent again from their
+** start, ahead of the Tx FIFO. cnt frames, in the order they were sent. */
+static void tc6_tx_again(spi_mpool_t **frames, uint16 cnt) {
+        if (cnt == 0) {
+                return;
+        }
+        if (tc6_frame_in(frames, cnt, Tc6TxFrame)) {
+                Tc6TxFrame = NULL;
+        }
+
+        /* the frames left in the list were not taken in this transfer */
+        memmove(Tc6TxRetry+cnt, Tc6TxRetry, Tc6TxRetryCnt * sizeof(Tc6TxRetry[0]));
+        memcpy(Tc6TxRetry, frames, cnt * sizeof(Tc6TxRetry[0]));
+        Tc6TxRetryCnt += cnt;
+        Tc6Stats.tx_retries += cnt;
+}
+
+
+
+/* One full-duplex data transfer: Tx chunks go out on MOSI while Rx chunks
+** come in on MISO. The chunk count is the larger of the Tx credits we can use
+** and the Rx chunks available, at least one so that the footer is refreshed.
+** Each chunk may start an Rx frame, so no more chunks take Rx data than there
+** are free pools, the others have NORX set and the MACPHY keeps the data. */
+static void tc6_data_xfer(void) {
+        spi_mpool_t *tx_frame[TC6_MAX_CHUNKS_PER_XFER]; /* Tx frame in progress at each chunk */
+        spi_mpool_t *again[TC6_MAX_CHUNKS_PER_XFER];
+        boolean tx_end[TC6_MAX_CHUNKS_PER_XFER];
+        boolean tx_bad[TC6_MAX_CHUNKS_PER_XFER]; /* the MACPHY did not take the chunk */
+        uint16 n_tx, n_rx, n, i, n_again = 0, rx_room;
+        uint16 csz = TC6_HDR_SZ + Tc6PayloadSz;
+        uint32 hdr, ftr;
+        uint8 *chunk;
+        boolean xfer_ok;
+
+        /* pools get free as the Tx frames are sent and the host reads the Rx ones */
+        n_tx = tc6_tx_pending() ? Tc6Stats.tx_credits : 0;
+        rx_room = (Tc6RxDoneCnt >= TC6_RX_FRAMES) ? 0 : get_spi_mpool_free_cnt();
+        n_rx = (Tc6Stats.rx_chunks_avail > rx_room) ? rx_room : Tc6Stats.rx_chunks_avail;
+        n = (n_tx > n_rx) ? n_tx : n_rx;
+        if (n > TC6_MAX_CHUNKS_PER_XFER) {
+                n = TC6_MAX_CHUNKS_PER_XFER;
+        }
+        if (n == 0) {
+                n = 1;
+        }
+
+        for (i = 0, chunk = Tc6SpiTx; i < n; i++, chunk += csz) {
+                hdr = TC6_HDR_DNC | (Tc6SeqBit ? TC6_HDR_SEQ : 0) | ((i >= n_rx) ? TC6_HDR_NORX : 0);
+                Tc6SeqBit = !Tc6SeqBit;
+                memset(chunk + TC6_HDR_SZ, 0, Tc6PayloadSz);
+                tx_frame[i] = NULL;
+                tx_end[i] = FALSE;
+                tx_bad[i] = FALSE;
+                if ((i < n_tx) && tc6_tx_pending()) {
+                        tx_frame[i] = tc6_tx_chunk(chunk, &hdr);
+                        tx_end[i] = (tx_frame[i] != NULL) ? TRUE : FALSE;
+                }
+                if (tx_frame[i] == NULL) {
+                        tx_frame[i] = Tc6TxFrame; // no Tx data, or the frame goes on
+                }
+                tc6_put_be32(chunk, tc6_add_parity(hdr));
+        }
+
+        Tc6Stats.xfers++;
+        xfer_ok = (tc6_spi_xfer(n * csz) == E_OK) ? TRUE : FALSE;
+        if (xfer_ok == FALSE) {
+                /* nothing is known of the chunks, the Rx frame has a gap now */
+                LOG_ERR("%s(): SPI transfer failed!", __func__);
+                Tc6Stats.xfer_errors++;
+                tc6_rx_drop();
+                for (i = 0; i < n; i++) {
+                        tx_bad[i] = TRUE;
+                }
+        }
+        else {
+                Tc6Stats.chunks += n;
+        }
+
+        for (i = 0, chunk = Tc6SpiRx; (i < n) && xfer_ok; i++, chunk += csz) {
+                ftr = tc6_get_be32(chunk + Tc6PayloadSz);
+                if (tc6_odd_bits(ftr) == 0) {
+                        Tc6Stats.ftr_errors++;
+                        tc6_rx_drop();
+                        continue;
+                }
+
+                if (ftr & TC6_FTR_HDRB) {
+                        /* the MACPHY ignored this chunk */
+                        Tc6Stats.hdr_errors++;
+                        tx_bad[i] = TRUE;
+                }
+                if ((ftr & TC6_FTR_SYNC) == 0) {
+                        if (Tc6NeedsConfig == FALSE) {
+                                Tc6Stats.sync_lost++;
+                        }
+                        Tc6NeedsConfig = TRUE;
+                }
+                if (ftr & TC6_FTR_EXST) {
+                        Tc6ExstPending = TRUE;
+                }
+
+                Tc6Stats.tx_credits = (ftr >> TC6_FTR_TXC_SHIFT) & TC6_FTR_TXC_MASK;
+                Tc6Stats.rx_chunks_avail = (ftr >> TC6_FTR_RCA_SHIFT) & TC6_FTR_RCA_MASK;
+
+                if ((ftr & TC6_FTR_DV) && (i < n_rx)) {
+                        tc6_rx_chunk(chunk, ftr);
+                }
+        }
+
+        for (i = 0; i < n; i++) {
+                if (tx_bad[i] && (tx_frame[i] != NULL) && !tc6_frame_in(again, n_again, tx_frame[i])) {
+                        again[n_again++] = tx_frame[i];
+                }
+        }
+
+        /* the last chunk of these frames is with the MACPHY now */
+        for (i = 0; i < n; i++) {
+                if (tx_end[i] && !tc6_frame_in(again, n_again, tx_frame[i])) {
+                        MACPHY_TRACE(TRC_TX_SPI_WR_DONE, tx_frame[i]->seq);
+                        Tc6Stats.tx_frames++;
+                        if (tx_frame[i]->tx_confirm) {
+                                put_spi_mpool_tx_done(tx_frame[i]);
+                        }
+                        free_spi_mpool(tx_frame[i]);
+                }
+        }
+        tc6_tx_again(again, n_again);
+}
+
+
+
+/* Exchanges data chunks until there is nothing to send or receive, bounded by
+** TC6_MAX_XFERS_PER_CALL. A partly sent frame is continued at once, as the
+** MACPHY may already be sending it (Tx cut-through). */
+static void tc6_service(void) {
+        uint8 i;
+
+        for (i = 0; i < TC6_MAX_XFERS_PER_CALL; i++) {
+                tc6_data_xfer();
+
+                if (tc6_tx_pending() && (Tc6Stats.tx_credits > 0)) {
+                        continue;
+                }
+                if ((Tc6Stats.rx_chunks_avail > 0) && (Tc6RxDoneCnt < TC6_RX_FRAMES) &&
+                        (get_spi_mpool_free_cnt() > 0)) {
+                        continue;
+                }
+                break;
+        }
+}
+
+
+
+static void tc6_read_status(void) {
+        uint32 status0, bufsts, phy_status;
+
+        Tc6ExstPending = FALSE;
+        if (FALSE == tc6_read_reg(TC6_MMS_STD, TC6_STATUS0, &status0)) {
+                return;
+        }
+        tc6_write_reg(TC6_MMS_STD, TC6_STATUS0, status0); // write 1 to clear
+        Tc6Stats.status0 |= status0;
+
+        if (status0 & (STATUS0_TXBOE | STATUS0_TXBUE | STATUS0_TXPE)) {
+                Tc6TxErrCounters.TxDroppedErrorPkts++;
+        }
+        if (status0 & STATUS0_RESETC) {
+                Tc6NeedsConfig = TRUE;
+        }
+        if (status0 & STATUS0_PHYINT) {
+                if (tc6_read_reg(TC6_MMS_STD, TC6_PHY_BASIC_STATUS, &phy_status)) {
+                        Tc6Stats.link_up = (phy_status & PHY_BASIC_STATUS_LINK) ? TRUE : FALSE;
+                }
+        }
+        if (tc6_read_reg(TC6_MMS_STD, TC6_BUFSTS, &bufsts)) {
+                Tc6Stats.tx_credits = (bufsts >> BUFSTS_TXC_SHIFT) & BUFSTS_TXC_MASK;
+                Tc6Stats.rx_chunks_avail = bufsts & BUFSTS_RCA_MASK;
+        }
+}
+
+
+
+/* Configures the MACPHY as per spi_cfg and the MAC address, SYNC is set last
+** to tell the MACPHY that the configuration is complete. */
+static boolean tc6_configure(void) {
+        const Eth_ConfigSpiCfgType *spi_cfg = &Tc6Cfg->spi_cfg;
+        const uint8 *mac = Tc6Cfg->ctrlcfg.mac_addres;
+        uint32 config0, regval;
+
+        switch (spi_cfg->pay_ld_size) {
+        case 8:  config0 = CONFIG0_CPS_8;  break;
+        case 16: config0 = CONFIG0_CPS_16; break;
+        case 32: config0 = CONFIG0_CPS_32; break;
+        case 64: config0 = CONFIG0_CPS_64; break;
+        default:
+                LOG_ERR("%s(): invalid chunk payload size %d!", __func__, spi_cfg->pay_ld_size);
+                return FALSE;
+        }
+        Tc6PayloadSz = spi_cfg->pay_ld_size;
+
+        /* clear the reset complete and error flags of the earlier config */
+        Tc6Prote = FALSE;
+        if (tc6_read_reg(TC6_MMS_STD, TC6_STATUS0, &regval)) {
+                tc6_write_reg(TC6_MMS_STD, TC6_STATUS0, regval);
+        }
+
+        config0 |= spi_cfg->txd_hdr_seq ? CONFIG0_SEQE : 0;
+        config0 |= spi_cfg->ctrldatprot ? CONFIG0_PROTE : 0;
+        config0 |= spi_cfg->tx_cut_thru ? CONFIG0_TXCTE : 0;
+        config0 |= spi_cfg->rx_cut_thru ? CONFIG0_RXCTE : 0;
+        config0 |= spi_cfg->rx_zero_aln ? CONFIG0_ZARFE : 0;
+        config0 |= spi_cfg->rx_cs_align ? CONFIG0_CSARFE : 0;
+        config0 |= (uint32)(spi_cfg->tx_crdthrsh & 0x03) << CONFIG0_TXCTHRESH_SHIFT;
+
+        /* protection applies to the accesses after CONFIG0 is written */
+        if (FALSE == tc6_write_reg(TC6_MMS_STD, TC6_CONFIG0, config0)) {
+                return FALSE;
+        }
+        Tc6Prote = spi_cfg->ctrldatprot;
+
+        /* MAC address and enable the MAC */
+        regval = mac[0] | (mac[1] << 8) | (mac[2] << 16) | ((uint32)mac[3] << 24);
+        tc6_write_reg(TC6_MMS_MAC, TC6_MAC_SAB1, regval);
+        tc6_write_reg(TC6_MMS_MAC, TC6_MAC_SAT1, mac[4] | (mac[5] << 8));
+        tc6_write_reg(TC6_MMS_MAC, TC6_MAC_NCR, MAC_NCR_TXEN | MAC_NCR_RXEN);
+
+        if (FALSE == tc6_write_reg(TC6_MMS_STD, TC6_CONFIG0, config0 | CONFIG0_SYNC)) {
+                return FALSE;
+        }
+        Tc6NeedsConfig = FALSE;
+        Tc6SeqBit = FALSE;
+
+        /* drop the half done frames, the MACPHY has lost them anyway */
+        tc6_rx_drop();
+        if (Tc6TxFrame != NULL) {
+                free_spi_mpool(Tc6TxFrame);
+                Tc6TxFrame = NULL;
+                Tc6TxErrCounters.TxDroppedErrorPkts++;
+        }
+        while (Tc6TxRetryCnt > 0) {
+                free_spi_mpool(Tc6TxRetry[--Tc6TxRetryCnt]);
+                Tc6TxErrCounters.TxDroppedErrorPkts++;
+        }
+
+        /* initial credits and link state */
+        tc6_read_status();
+        if (tc6_read_reg(TC6_MMS_STD, TC6_PHY_BASIC_STATUS, &regval)) {
+                Tc6Stats.link_up = (regval & PHY_BASIC_STATUS_LINK) ? TRUE : FALSE;
+        }
+
+        return TRUE;
+}
+
+
+
+//////////////////////////////////////////////
+// Global Functions
+boolean tc6_read_reg(uint8 mms, uint16 addr, uint32 *data) {
+        return tc6_ctrl_xfer(FALSE, mms, addr, data, 1);
+}
+
+
+
+boolean tc6_write_reg(uint8 mms, uint16 addr, uint32 data) {
+        return tc6_ctrl_xfer(TRUE, mms, addr, &data, 1);
+}
+
+
+
+boolean tc6_pkt_send(uint8 *pktptr, uint16 pktlen) {
+        spi_mpool_t *mpool;
+
+        if ((pktptr == NULL) || (pktlen+MEM_POOL_TX_DATA_OFS > MEM_POOL_BUF_LEN)) {
+                return FALSE;
+        }
+
+        /* get memory pool for ethernet frame transfer, no pool = no Tx credit */
+        mpool = get_new_spi_mpool_tx();
+        if (mpool == NULL) {
+                Tc6TxErrCounters.TxDroppedNoErrorPkts++;
+                return FALSE;
+        }
+
+        MACPHY_TRACE(TRC_TX_BUF_PROVIDED, mpool->seq);
+        memcpy(mpool->tx_buf+MEM_POOL_TX_DATA_OFS, pktptr, pktlen);
+        mpool->dlen = pktlen;
+
+        return tc6_mpool_send(mpool);
+}
+
+
+
+/* Queues a frame from a Tx pool, its chunks are sent right away as far as
+** the Tx credits allow, the rest on the next service calls. */
+boolean tc6_mpool_send(spi_mpool_t *mpool) {
+        if (mpool == NULL) {
+                return FALSE;
+        }
+
+        if (FALSE == put_spi_mpool_w_data(mpool)) {
+                free_spi_mpool(mpool);
+                Tc6TxErrCounters.TxDroppedNoErrorPkts++;
+                return FALSE;
+        }
+
+        if ((Tc6NeedsConfig == FALSE) && (Tc6Stats.tx_credits > 0)) {
+                tc6_service();
+        }
+
+        return TRUE;
+}
+
+
+
+uint16 tc6_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+        spi_mpool_t *mpool;
+        uint16 pktlen;
+
+        if ((Tc6RxDoneCnt == 0) && (Tc6Stats.rx_chunks_avail > 0) && (Tc6NeedsConfig == FALSE)) {
+                tc6_service();
+        }
+        if (Tc6RxDoneCnt == 0) {
+                return 0;
+        }
+
+        mpool = Tc6RxDone[Tc6RxDoneHead];
+        Tc6RxDoneHead = (Tc6RxDoneHead + 1) % TC6_RX_FRAMES;
+        Tc6RxDoneCnt--;
+
+        pktlen = (mpool->dlen > maxlen) ? maxlen : mpool->dlen;
+        memcpy(pktptr, mpool->rx_buf, pktlen);
+        MACPHY_TRACE(TRC_RX_DELIVERED, mpool->seq);
+        free_spi_mpool(mpool);
+
+        return pktlen;
+}
+
+
+
+void tc6_periodic_fn(void) {
+        if (Tc6NeedsConfig) {
+                LOG_WRN("TC6 MACPHY lost SYNC, configuring again");
+                if (FALSE == tc6_configure()) {
+                        return;
+                }
+        }
+
+        if (Tc6ExstPending) {
+                tc6_read_status();
+        }
+
+        /* also polls the footer for the Rx chunks available and Tx credits */
+        tc6_service();
+}
+
+
+
+/* frames ready for the host plus one if the MACPHY has more chunks */
+uint8 tc6_rx_pending(void) {
+        return (uint8)(Tc6RxDoneCnt + ((Tc6Stats.rx_chunks_avail > 0) ? 1 : 0));
+}
+
+
+
+uint8 tc6_tx_credit(void) {
+        return (uint8) get_spi_mpool_tx_credit();
+}
+
+
+
+void tc6_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs) {
+        if (cntrs != NULL) {
+                *cntrs = Tc6TxErrCounters;
+        }
+}
+
+
+
+/* STATUS0 bits seen since the last call, in Eth_SpiStatusType bit positions */
+uint32 tc6_spi_status(void) {
+        static const struct {
+                uint32 status0;
+                uint8  bit;
+        } map[] = {
+                { STATUS0_TXPE,   TRANSMIT_PROTOCOL_ERROR_BIT },
+                { STATUS0_TXBOE,  TRANSMIT_BUFFER_OVERFLOW_ERROR },
+                { STATUS0_TXBUE,  TRANSMIT_BUFFER_UNDERFLOW_ERROR },
+                { STATUS0_RXBOE,  RECEIVE_BUFFER_OVERFLOW_ERROR },
+                { STATUS0_LOFE,   LOSS_FRAMING_ERROR },
+                { STATUS0_HDRE,   HEADER_ERROR },
+                { STATUS0_RESETC, RESET_COMPLETE },
+                { STATUS0_PHYINT, PHY_INTERRUPT },
+                { STATUS0_TTSCAA, TRANSMIT_TIMESTAMP_CAPTURE_AVAILABLE_A },
+                { STATUS0_TTSCAB, TRANSMIT_TIMESTAMP_CAPTURE_AVAILABLE_B },
+                { STATUS0_TTSCAC, TRANSMIT_TIMESTAMP_CAPTURE_AVAILABLE_C },
+                { STATUS0_TXFCSE, TRANSMIT_FRAME_CHECK_SEQUENCE_ERROR },
+                { STATUS0_CDPE,   CONTROL_DATA_PROTECTION_ERROR }
+        };
+        uint32 status = 0;
+        uint8 i;
+
+        for (i = 0; i < sizeof(map)/sizeof(map[0]); i++) {
+                if (Tc6Stats.status0 & map[i].status0) {
+                        status |= (1UL << map[i].bit);
+                }
+        }
+        Tc6Stats.status0 = 0;
+
+        return status;
+}
+
+
+
+void tc6_get_stats(tc6_stats_t *stats) {
+        if (stats != NULL) {
+                *stats = Tc6Stats;
+        }
+}
+
+
+
+boolean tc6_init(const Eth_ConfigType *cfg) {
+        uint32 regval;
+        uint16 i;
+
+        if (cfg == NULL) {
+                return FALSE;
+        }
+        Tc6Cfg = cfg;
+        Tc6Prote = FALSE;
+        Tc6NeedsConfig = TRUE;
+
+        /* soft reset and wait for it to complete */
+        tc6_write_reg(TC6_MMS_STD, TC6_RESET, RESET_SWRESET);
+        for (i = 0; i < TC6_RESET_POLL_CNT; i++) {
+                k_busy_wait(10);
+                if (tc6_read_reg(TC6_MMS_STD, TC6_STATUS0, &regval) && (regval & STATUS0_RESETC)) {
+                        break;
+                }
+        }
+        if (i == TC6_RESET_POLL_CNT) {
+                LOG_ERR("%s(): MACPHY reset did not complete!", __func__);
+                return FALSE;
+        }
+        tc6_write_reg(TC6_MMS_STD, TC6_STATUS0, STATUS0_RESETC);
+
+        if (tc6_read_reg(TC6_MMS_STD, TC6_IDVER, &regval)) {
+                LOG_DBG("TC6 IDVER: 0x%08x", regval);
+        }
+        if (tc6_read_reg(TC6_MMS_STD, TC6_PHYID, &regval)) {
+                LOG_DBG("TC6 PHYID: 0x%08x", regval);
+        }
+
+        if (FALSE == tc6_configure()) {
+                return FALSE;
+        }
+
+        LOG_DBG("TC6 init complete!");
+
+        return TRUE;
+}
+
+
+
+const macphy_ops_t Tc6MacPhyOps = {
+        .name = "OA TC6",
+        .init = tc6_init,
+        .periodic_fn = tc6_periodic_fn,
+        .pkt_send = tc6_pkt_send,
+        .mpool_send = tc6_mpool_send,
+        .pkt_recv = tc6_pkt_recv,
+        .rx_pending = tc6_rx_pending,
+        .tx_credit = tc6_tx_credit,
+        .get_tx_err_counters = tc6_get_tx_err_counters,
+        .spi_status = tc6_spi_status,
+        .set_rx_classifier = NULL,
+        .irq_notify = NULL,
+        .rx_polling = NULL,
+        .frags_send = NULL,
+        .get_rx_ts = NULL,
+        .tx_service = NULL      /* the Tx chunks go with the Rx ones, see tc6_service */
+};
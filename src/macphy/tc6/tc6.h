@@ -0,0 +1,78 @@
+/*
+ * Created on Mon Oct 19 2026 2:31:17 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ETH_TC6_H
+#define ETH_TC6_H
+
+#include <Eth_GeneralTypes.h>
+#include <Eth_cfg.h>
+#include <macphy_mpool.h>
+#include <macphy_ops.h>
+
+#include "tc6_regs.h"
+
+
+/////////////////////////////////////////
+///   Declarations & Definitions       //
+/////////////////////////////////////////
+typedef struct {
+        uint32  xfers;          /* data chunk SPI transfers */
+        uint32  chunks;
+        uint32  tx_chunks;      /* chunks that carried Tx data */
+        uint32  rx_chunks;      /* chunks that carried Rx data */
+        uint32  tx_frames;
+        uint32  rx_frames;
+        uint32  rx_dropped;     /* FD set, no free mpool or too long */
+        uint32  hdr_errors;     /* HDRB, MACPHY rejected our header */
+        uint32  xfer_errors;    /* failed SPI transfers of data chunks */
+        uint32  tx_retries;     /* frames sent again after HDRB or a failed transfer */
+        uint32  ftr_errors;     /* footer parity errors */
+        uint32  ctrl_errors;    /* control transaction echo / protection errors */
+        uint32  sync_lost;      /* MACPHY lost its configuration */
+        uint32  status0;        /* STATUS0 bits seen since the last tc6_spi_status */
+        uint8   tx_credits;     /* TXC of the last footer */
+        uint8   rx_chunks_avail;/* RCA of the last footer */
+        boolean link_up;
+} tc6_stats_t;
+
+
+
+// public functions, called via Tc6MacPhyOps
+extern const macphy_ops_t Tc6MacPhyOps;
+
+boolean tc6_init(const Eth_ConfigType *cfg);
+void    tc6_periodic_fn(void);
+boolean tc6_pkt_send(uint8 *pktptr, uint16 pktlen);
+boolean tc6_mpool_send(spi_mpool_t *mpool);
+uint16  tc6_pkt_recv(uint8 *pktptr, uint16 maxlen);
+uint8   tc6_rx_pending(void);
+uint8   tc6_tx_credit(void);
+void    tc6_get_tx_err_counters(Eth_TxErrorCounterValuesType *cntrs);
+uint32  tc6_spi_status(void);
+
+void    tc6_get_stats(tc6_stats_t *stats);
+
+
+// private functions
+boolean tc6_read_reg(uint8 mms, uint16 addr, uint32 *data);
+boolean tc6_write_reg(uint8 mms, uint16 addr, uint32 data);
+
+
+#endif
@@ -0,0 +1,5 @@
+INCDIRS  += -I ${ETH_PATH}/src/macphy/tc6
+
+
+ETH_OBJS += \
+	${ETH_PATH}/src/macphy/tc6/tc6.o 
\ No newline at end of file
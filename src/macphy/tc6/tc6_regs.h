@@ -0,0 +1,163 @@
+/*
+ * Created on Mon Oct 19 2026 2:31:17 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ETH_TC6_REGS_H
+#define ETH_TC6_REGS_H
+
+// OPEN Alliance 10BASE-T1x MAC-PHY Serial Interface (TC6) definitions. All
+// headers, footers and register words are sent MSB first on the SPI.
+
+
+/////////////////////////////////////////
+///        DATA CHUNK HEADER           //
+/////////////////////////////////////////
+#define TC6_HDR_DNC             (0x80000000UL) /* 1: data, 0: control */
+#define TC6_HDR_SEQ             (0x40000000UL)
+#define TC6_HDR_NORX            (0x20000000UL) /* host can't take Rx data */
+#define TC6_HDR_DV              (0x00200000UL) /* Tx data valid */
+#define TC6_HDR_SV              (0x00100000UL) /* start of frame valid */
+#define TC6_HDR_SWO_SHIFT       (16)           /* start word offset */
+#define TC6_HDR_EV              (0x00004000UL) /* end of frame valid */
+#define TC6_HDR_EBO_SHIFT       (8)            /* end byte offset */
+#define TC6_HDR_P               (0x00000001UL) /* odd parity of bits 31:1 */
+
+
+
+/////////////////////////////////////////
+///        DATA CHUNK FOOTER           //
+/////////////////////////////////////////
+#define TC6_FTR_EXST            (0x80000000UL) /* extended status, read STATUS0 */
+#define TC6_FTR_HDRB            (0x40000000UL) /* header bad */
+#define TC6_FTR_SYNC            (0x20000000UL) /* MACPHY configured */
+#define TC6_FTR_RCA_SHIFT       (24)           /* Rx chunks available */
+#define TC6_FTR_RCA_MASK        (0x1F)
+#define TC6_FTR_DV              (0x00200000UL)
+#define TC6_FTR_SV              (0x00100000UL)
+#define TC6_FTR_SWO_SHIFT       (16)
+#define TC6_FTR_SWO_MASK        (0x0F)
+#define TC6_FTR_FD              (0x00008000UL) /* frame drop */
+#define TC6_FTR_EV              (0x00004000UL)
+#define TC6_FTR_EBO_SHIFT       (8)
+#define TC6_FTR_EBO_MASK        (0x3F)
+#define TC6_FTR_RTSA            (0x00000080UL) /* Rx timestamp added */
+#define TC6_FTR_RTSP            (0x00000040UL)
+#define TC6_FTR_TXC_SHIFT       (1)            /* Tx credits */
+#define TC6_FTR_TXC_MASK        (0x1F)
+#define TC6_FTR_P               (0x00000001UL)
+
+
+
+/////////////////////////////////////////
+///       CONTROL COMMAND HEADER       //
+/////////////////////////////////////////
+#define TC6_CTL_HDRB            (0x40000000UL) /* in the echoed header */
+#define TC6_CTL_WNR             (0x20000000UL) /* write not read */
+#define TC6_CTL_AID             (0x10000000UL) /* address increment disable */
+#define TC6_CTL_MMS_SHIFT       (24)
+#define TC6_CTL_ADDR_SHIFT      (8)
+#define TC6_CTL_LEN_SHIFT       (1)            /* number of registers - 1 */
+#define TC6_CTL_P               (0x00000001UL)
+
+// Memory Map Selectors
+#define TC6_MMS_STD             (0x00) /* standard control & status, PHY clause 22 */
+#define TC6_MMS_MAC             (0x01)
+
+
+
+/////////////////////////////////////////
+///   STANDARD REGISTERS (MMS = 0)     //
+/////////////////////////////////////////
+#define TC6_IDVER               (0x0000)
+#define TC6_PHYID               (0x0001)
+#define TC6_STDCAP              (0x0002)
+#define TC6_RESET               (0x0003)
+#define TC6_CONFIG0             (0x0004)
+#define TC6_STATUS0             (0x0008)
+#define TC6_STATUS1             (0x0009)
+#define TC6_BUFSTS              (0x000B)
+#define TC6_IMASK0              (0x000C)
+#define TC6_IMASK1              (0x000D)
+#define TC6_PHY_BASIC_CTRL      (0xFF00) /* clause 22 registers from here */
+#define TC6_PHY_BASIC_STATUS    (0xFF01)
+
+// RESET Register Bit Definitions
+#define RESET_SWRESET           (0x00000001UL)
+
+// CONFIG0 Register Bit Definitions
+#define CONFIG0_SYNC            (0x00008000UL)
+#define CONFIG0_TXFCSVE         (0x00004000UL)
+#define CONFIG0_CSARFE          (0x00002000UL)
+#define CONFIG0_ZARFE           (0x00001000UL)
+#define CONFIG0_TXCTHRESH_SHIFT (10)
+#define CONFIG0_TXCTE           (0x00000200UL) /* Tx cut-through */
+#define CONFIG0_RXCTE           (0x00000100UL) /* Rx cut-through */
+#define CONFIG0_FTSE            (0x00000080UL)
+#define CONFIG0_FTSS            (0x00000040UL)
+#define CONFIG0_PROTE           (0x00000020UL) /* control data protection */
+#define CONFIG0_SEQE            (0x00000010UL) /* Tx data header SEQ check */
+#define CONFIG0_CPS_8           (0x00000003UL) /* chunk payload size */
+#define CONFIG0_CPS_16          (0x00000004UL)
+#define CONFIG0_CPS_32          (0x00000005UL)
+#define CONFIG0_CPS_64          (0x00000006UL)
+
+// STATUS0 Register Bit Definitions, all are write 1 to clear
+#define STATUS0_CDPE            (0x00001000UL)
+#define STATUS0_TXFCSE          (0x00000800UL)
+#define STATUS0_TTSCAC          (0x00000400UL)
+#define STATUS0_TTSCAB          (0x00000200UL)
+#define STATUS0_TTSCAA          (0x00000100UL)
+#define STATUS0_PHYINT          (0x00000080UL)
+#define STATUS0_RESETC          (0x00000040UL)
+#define STATUS0_HDRE            (0x00000020UL)
+#define STATUS0_LOFE            (0x00000010UL)
+#define STATUS0_RXBOE           (0x00000008UL)
+#define STATUS0_TXBUE           (0x00000004UL)
+#define STATUS0_TXBOE           (0x00000002UL)
+#define STATUS0_TXPE            (0x00000001UL)
+
+// BUFSTS Register Bit Definitions
+#define BUFSTS_TXC_SHIFT        (8)
+#define BUFSTS_TXC_MASK         (0xFF)
+#define BUFSTS_RCA_MASK         (0xFF)
+
+// PHY Basic Status Register Bit Definitions
+#define PHY_BASIC_STATUS_LINK   (0x0004)
+
+
+
+/////////////////////////////////////////
+///     MAC REGISTERS (MMS = 1)        //
+/////////////////////////////////////////
+// The MAC block layout is vendor specific, these are of the LAN865x family
+#define TC6_MAC_NCR             (0x0000)
+#define TC6_MAC_NCFGR           (0x0001)
+#define TC6_MAC_SAB1            (0x0022) /* MAC address bytes 0..3 */
+#define TC6_MAC_SAT1            (0x0023) /* MAC address bytes 4..5 */
+
+// MAC_NCR Register Bit Definitions
+#define MAC_NCR_TXEN            (0x00000008UL)
+#define MAC_NCR_RXEN            (0x00000004UL)
+
+// MAC_NCFGR Register Bit Definitions
+#define MAC_NCFGR_MTIHEN        (0x00000040UL) /* multicast hash */
+#define MAC_NCFGR_CAF           (0x00000010UL) /* copy all frames */
+
+
+#endif
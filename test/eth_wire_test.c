@@ -0,0 +1,1076 @@
+/*
+ * Created on Mon Oct 19 2026 9:41:07 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <dlfcn.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Spi.h>
+#include <Eth.h>
+#include <enc28j60.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+
+// Two node virtual wire. The driver is loaded twice (build/eth_node0.so and
+// build/eth_node1.so are the same objects, so each copy has its own static
+// state), each copy on a simulated ENC28J60 behind the fake SPI. The two are
+// joined by a full duplex wire with a rate, a propagation delay, frame loss
+// and reordering. The traffic goes through Eth_ProvideTxBuffer, Eth_Transmit
+// and Eth_Receive; the payload carries a sequence number and the send time.
+//
+// The ENC28J60 model has the banked registers (with the dummy byte of the
+// MAC / MII reads), the 8 KB buffer with the auto-incremented ERDPT / EWRPT,
+// the Rx ring as the MAC fills it (next packet pointer, RSV, frame, FCS, kept
+// off ERXRDPT), EPKTCNT / PKTDEC, the MII access and scan timing, TXRTS with
+// the TSV at ETXND+1, the DMA and the PAUSE flow control (EFLOCON of the
+// receiver holds the sender's MAC).
+//
+// Each node runs on its own simulated time: the node that is behind runs its
+// next step (the application, the Eth_Receive loop and Eth_MainFunction), and
+// its SPI transfers move its time on. A frame goes into the Rx ring of the
+// receiver once the receiver's time has passed its arrival, hence a node sees
+// the frames of the other one at most one step late.
+#define SIM_MEM_SZ              (0x2000)
+#define SIM_REVID               (0x06)  /* B7, no errata 12 workaround */
+#define SIM_MII_NS              (10240)
+#define SIM_SPI_HZ              (20000000ull)
+#define SIM_SPI_JOB_NS          (400)   /* CS setup / hold and the Spi call, per job */
+#define SIM_STEP_NS             (2000)  /* CPU time of a step besides the SPI */
+#define SIM_SPI_CHANNELS        (16)
+#define SIM_WIRE_SLOTS          (64)
+#define SIM_WIRE_OVERHEAD       (8 + 4 + 12) /* preamble + SFD, FCS, inter frame gap */
+#define SIM_RX_HDR_SZ           (6)     /* next packet pointer + RSV */
+#define SIM_MIN_FRAME           (60)
+#define SIM_MAX_FRAME           (1514)
+#define SIM_RX_LOOP             (16)    /* Eth_Receive calls per step */
+
+#define SIM_ETH_TYPE            (0x88B5) /* local experimental */
+#define SIM_MIN_PAYLOAD         (SIM_MIN_FRAME - 14)
+#define SIM_MAX_PAYLOAD         (SIM_MAX_FRAME - 14)
+#define SIM_RUN_NS              (200000000ull)
+#define SIM_DRAIN_NS            (20000000ull)
+#define SIM_PINGS               (1000)
+#define SIM_PING_LEN            (64)
+#define SIM_PING_TIMEOUT_NS     (5000000ull)
+#define SIM_MAX_SEQ             (1 << 16)
+#define SIM_MAX_SAMPLES         (1 << 16)
+
+// payload layout, host byte order
+#define PL_SEQ                  (0)     /* uint32 */
+#define PL_TS                   (4)     /* uint64, send time in ns */
+#define PL_LEN                  (12)    /* uint16, payload length */
+#define PL_KIND                 (14)
+#define PL_HDR_SZ               (16)
+
+typedef enum {
+        PL_DATA,
+        PL_PING,
+        PL_PONG
+} payload_kind_t;
+
+typedef enum {
+        PAT_PING_PONG,
+        PAT_UNIDIR,
+        PAT_BIDIR,
+        MAX_PAT
+} pattern_t;
+
+typedef struct {
+        const char *name;
+        uint32  mbps;
+        uint32  prop_ns;
+        uint32  loss_ppm;       /* frames lost per million */
+        uint32  reorder_ppm;    /* frames held back per million */
+        uint32  reorder_ns;     /* extra delay of a held back frame */
+} wire_cfg_t;
+
+typedef struct {
+        uint64  arrive;
+        uint16  len;
+        boolean used;
+        uint8   data[SIM_MAX_FRAME];
+} wire_frame_t;
+
+typedef struct {
+        /* sender */
+        uint32  tx_seq;         /* frames taken by Eth_Transmit */
+        uint64  tx_bytes;
+        uint32  tx_busy;        /* no Tx buffer, tried again on the next step */
+        uint32  tx_errors;
+
+        /* receiver */
+        uint32  rx_frames;
+        uint64  rx_bytes_win;   /* payload received within the run time */
+        uint32  rx_bad;
+        uint32  rx_dups;
+        uint32  rx_reordered;   /* came after a higher sequence number */
+        uint32  rx_next;        /* highest sequence number seen + 1 */
+        uint8   rx_seen[SIM_MAX_SEQ / 8];
+        uint32  lat_cnt;
+        uint32  lat_ns[SIM_MAX_SAMPLES];
+
+        /* ping-pong */
+        boolean ping_out;
+        uint64  ping_sent;
+        uint32  pings;
+        uint32  pongs;
+        uint32  ping_lost;
+        boolean pong_due;
+        uint32  pong_seq;
+        uint64  pong_ts;
+
+        uint64  rnd;
+} app_t;
+
+typedef struct {
+        int     id;
+        void    *so;
+        __typeof__(Eth_Init)             *init;
+        __typeof__(Eth_SetUpperLayerCbk) *set_cbk;
+        __typeof__(Eth_ProvideTxBuffer)  *provide;
+        __typeof__(Eth_Transmit)         *transmit;
+        __typeof__(Eth_Receive)          *receive;
+        __typeof__(Eth_MainFunction)     *main_fn;
+
+        /* ENC28J60 model, the common registers (0x1B..0x1F) are kept in bank 0 */
+        uint8   regs[4][32];
+        uint8   mem[SIM_MEM_SZ];
+        uint16  phy[32];
+        uint16  rx_wr;          /* ERXWRPT */
+        uint8   pktcnt;         /* EPKTCNT */
+        boolean mii_scan;
+        uint64  mii_busy;       /* MISTAT.BUSY until */
+        boolean tx_on;          /* TXRTS is set */
+        boolean tx_started;     /* the frame is on the wire until tx_end */
+        uint64  tx_end;
+        uint16  tx_len;
+
+        /* frames on the way to this node, and the Tx side of the wire */
+        wire_frame_t inq[SIM_WIRE_SLOTS];
+        uint64  wire_free;
+
+        uint64  now;
+        uint32  wire_frames;
+        uint32  wire_lost;
+        uint32  wire_held;      /* frames held back for the reordering */
+        uint32  pause_waits;    /* Tx starts held by the PAUSE of the peer */
+        uint32  rx_overflows;   /* no room in the Rx ring, EIR.RXERIF */
+        uint32  rx_filtered;
+        uint64  spi_ns;         /* SPI busy in the measured part of the run */
+        uint64  spi_bytes;
+
+        app_t   app;
+} node_t;
+
+
+#define SIM_NODE_CFG(id) { \
+        .general = { \
+                .mainfn_period_ms = 1, \
+                .mainfn_bdgt_frm = 16, \
+                .mainfn_bdgt_us = 2000 \
+        }, \
+        .ctrlcfg = { \
+                .enable_mii = TRUE, \
+                .enable_spi = TRUE, \
+                .spi_device = ETH_DEV_ENC28J60, \
+                .mac_lr_spd = ETH_MAC_LAYER_SPEED_10M, \
+                .mac_addres = { 0x02, 0x00, 0x5E, 0x10, 0x00, (id) } \
+        } \
+}
+
+static const Eth_ConfigType NodeCfg[2][ETH_DRIVER_MAX_CHANNEL] = {
+        { SIM_NODE_CFG(0x01) },
+        { SIM_NODE_CFG(0x02) }
+};
+
+static const wire_cfg_t Wires[] = {
+        { "10 Mbit/s, 100 m, no loss", 10, 500, 0, 0, 0 },
+        { "100 Mbit/s, 1 km, 1% loss, 2% reordered", 100, 5000, 10000, 20000, 3000000 }
+};
+
+static const char *PatName[MAX_PAT] = { "ping-pong", "unidirectional", "bidirectional" };
+static const uint16 MixedSizes[] = { 46, 64, 128, 256, 512, 1024, 1500 };
+
+static node_t Nodes[2];
+static node_t *CurNode;
+static const wire_cfg_t *Wire;
+static uint64 RunStart, RunEnd; /* the measured part of the run */
+static uint64 WireRnd = 0x2545F4914F6CDD1Dull;
+
+
+
+static uint32 rnd32(uint64 *state) {
+        *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+        return (uint32)(*state >> 33);
+}
+
+
+static node_t *peer(node_t *n) {
+        return &Nodes[n->id ^ 1];
+}
+
+
+
+//////////////////////////////////////////////
+// ENC28J60 registers, a key is the bank << 8 | address, the common ones have no bank
+#define SIM_KEY(reg)            (((reg) & 0x1F) >= 0x1B ? ((reg) & 0x1F) : ((reg) & 0x31F))
+
+static uint8 *sim_reg(node_t *n, uint16 key) {
+        return &n->regs[(key >> 8) & 0x03][key & 0x1F];
+}
+
+
+static uint16 sim_reg16(node_t *n, uint16 reg) {
+        return *sim_reg(n, SIM_KEY(reg)) | (*sim_reg(n, SIM_KEY(reg) + 1) << 8);
+}
+
+
+static void sim_reg16_set(node_t *n, uint16 reg, uint16 val) {
+        *sim_reg(n, SIM_KEY(reg)) = LO_BYTE(val);
+        *sim_reg(n, SIM_KEY(reg) + 1) = HI_BYTE(val);
+}
+
+
+/* MAC and MII registers send a dummy byte before the data */
+static boolean sim_is_mac_mii(uint16 key) {
+        return ((key & 0x300) == 0x200) || (key == SIM_KEY(MISTAT)) ||
+                ((key >= SIM_KEY(MAADR1)) && (key <= SIM_KEY(MAADR4)));
+}
+
+
+static uint16 sim_rx_next(node_t *n, uint16 ptr) {
+        return (ptr == sim_reg16(n, ERXNDL)) ? sim_reg16(n, ERXSTL) : (ptr + 1) % SIM_MEM_SZ;
+}
+
+
+static void sim_mac_addr(node_t *n, uint8 *mac) {
+        mac[0] = *sim_reg(n, SIM_KEY(MAADR5));
+        mac[1] = *sim_reg(n, SIM_KEY(MAADR4));
+        mac[2] = *sim_reg(n, SIM_KEY(MAADR3));
+        mac[3] = *sim_reg(n, SIM_KEY(MAADR2));
+        mac[4] = *sim_reg(n, SIM_KEY(MAADR1));
+        mac[5] = *sim_reg(n, SIM_KEY(MAADR0));
+}
+
+
+static void sim_reset(node_t *n) {
+        memset(n->regs, 0, sizeof(n->regs));
+        memset(n->phy, 0, sizeof(n->phy));
+        *sim_reg(n, SIM_KEY(ESTAT)) = ESTAT_CLKRDY;
+        *sim_reg(n, SIM_KEY(EREVID)) = SIM_REVID;
+        sim_reg16_set(n, ERXSTL, 0x05FA);
+        sim_reg16_set(n, ERXNDL, 0x1FFF);
+        sim_reg16_set(n, ERDPTL, 0x05FA);
+        n->rx_wr = 0x05FA;
+        n->pktcnt = 0;
+        n->mii_scan = FALSE;
+        n->tx_on = FALSE;
+        n->tx_started = FALSE;
+}
+
+
+
+//////////////////////////////////////////////
+// PHY, the wire is always connected
+static uint16 sim_phy_read(node_t *n, uint8 addr) {
+        boolean link = TRUE;
+        uint16 val;
+
+        switch (addr) {
+        case PHSTAT1:
+                return (link ? PHSTAT1_LLSTAT : 0) | PHSTAT1_PFDPX | PHSTAT1_PHDPX;
+        case PHSTAT2:
+                return (link ? PHSTAT2_LSTAT : 0) | ((n->phy[PHCON1] & PHCON1_PDPXMD) ? PHSTAT2_DPXSTAT : 0);
+        case PHID1:
+                return 0x0083;
+        case PHID2:
+                return 0x1400;
+        case PHIR:
+                val = n->phy[PHIR];
+                n->phy[PHIR] = 0; // cleared by the read
+                return val;
+        default:
+                return n->phy[addr & 0x1F];
+        }
+}
+
+
+static void sim_phy_write(node_t *n, uint8 addr, uint16 val) {
+        if ((addr == PHCON1) && (val & PHCON1_PRST)) {
+                memset(n->phy, 0, sizeof(n->phy));
+                return;
+        }
+        n->phy[addr & 0x1F] = val;
+}
+
+
+static void sim_mird_load(node_t *n) {
+        uint16 val = sim_phy_read(n, *sim_reg(n, SIM_KEY(MIREGADR)));
+
+        sim_reg16_set(n, MIRDL, val);
+}
+
+
+
+//////////////////////////////////////////////
+// MAC Rx: the frame (no FCS) goes into the Rx ring behind a 6 byte header
+static void sim_rx_frame(node_t *n, const uint8 *frame, uint16 len) {
+        static const uint8 bcast[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+        uint16 st = sim_reg16(n, ERXSTL), nd = sim_reg16(n, ERXNDL), rd = sim_reg16(n, ERXRDPTL);
+        uint16 need = (SIM_RX_HDR_SZ + len + 4 + 1) & ~1;
+        uint16 room, next, p, i;
+        boolean is_bcast = (memcmp(frame, bcast, 6) == 0);
+        uint8 mac[6], hdr[SIM_RX_HDR_SZ];
+
+        sim_mac_addr(n, mac);
+        if (!(*sim_reg(n, SIM_KEY(ECON1)) & ECON1_RXEN) || (!is_bcast && memcmp(frame, mac, 6))) {
+                n->rx_filtered++;
+                return;
+        }
+
+        if (n->rx_wr > rd) {
+                room = (nd - st) - (n->rx_wr - rd);
+        }
+        else if (n->rx_wr == rd) {
+                room = nd - st;
+        }
+        else {
+                room = rd - n->rx_wr - 1;
+        }
+        if ((n->pktcnt == 0xFF) || (need > room)) {
+                *sim_reg(n, SIM_KEY(EIR)) |= EIR_RXERIF;
+                n->rx_overflows++;
+                return;
+        }
+
+        next = st + (n->rx_wr - st + need) % (nd - st + 1);
+        hdr[0] = LO_BYTE(next);
+        hdr[1] = HI_BYTE(next);
+        hdr[2] = LO_BYTE(len + 4);
+        hdr[3] = HI_BYTE(len + 4);
+        hdr[4] = 0x80;                  // RSV bit 23, received ok
+        hdr[5] = is_bcast ? 0x02 : 0;   // RSV bit 25, broadcast
+        p = n->rx_wr;
+        for (i = 0; i < SIM_RX_HDR_SZ + len + 4; i++) {
+                if (i < SIM_RX_HDR_SZ) {
+                        n->mem[p] = hdr[i];
+                }
+                else if (i < SIM_RX_HDR_SZ + len) {
+                        n->mem[p] = frame[i - SIM_RX_HDR_SZ];
+                }
+                else {
+                        n->mem[p] = 0; // FCS, not checked by the driver
+                }
+                p = sim_rx_next(n, p);
+        }
+
+        n->rx_wr = next;
+        n->pktcnt++;
+        *sim_reg(n, SIM_KEY(EIR)) |= EIR_PKTIF;
+}
+
+
+
+//////////////////////////////////////////////
+// MAC Tx and the wire
+static boolean sim_paused(node_t *n) {
+        return (*sim_reg(n, SIM_KEY(EFLOCON)) & (EFLOCON_FCEN1 | EFLOCON_FCEN0)) == EFLOCON_FC_XOFF;
+}
+
+
+static void sim_wire_put(node_t *dst, const uint8 *frame, uint16 len, uint64 arrive) {
+        uint16 i;
+
+        for (i = 0; i < SIM_WIRE_SLOTS; i++) {
+                if (dst->inq[i].used == FALSE) {
+                        dst->inq[i].used = TRUE;
+                        dst->inq[i].arrive = arrive;
+                        dst->inq[i].len = len;
+                        memcpy(dst->inq[i].data, frame, len);
+                        return;
+                }
+        }
+        LOG_ERR("%s: no free wire slot!", __func__);
+}
+
+
+/* The frame between ETXST+1 (ETXST has the control byte) and ETXND goes on
+** the wire once it and the receiver are free. It is padded to 60 bytes. */
+static void sim_tx_begin(node_t *n) {
+        uint16 st = sim_reg16(n, ETXSTL), nd = sim_reg16(n, ETXNDL);
+        uint8 frame[SIM_MAX_FRAME + 8];
+        uint16 len = (uint16)(nd - st);
+        uint64 start, now = k_cycle_get_64();
+        node_t *dst = peer(n);
+        uint32 extra = 0;
+
+        if (sim_paused(dst)) {
+                n->pause_waits++;
+                return;
+        }
+        if ((nd <= st) || (len > sizeof(frame))) {
+                LOG_ERR("%s: bad Tx pointers 0x%04x..0x%04x!", __func__, st, nd);
+                len = 0;
+        }
+
+        memset(frame, 0, sizeof(frame));
+        memcpy(frame, n->mem + st + 1, len);
+        n->tx_len = len;
+        len = (len < SIM_MIN_FRAME) ? SIM_MIN_FRAME : len;
+        start = (now > n->wire_free) ? now : n->wire_free;
+        n->tx_end = start + (uint64)(len + SIM_WIRE_OVERHEAD) * 8 * 1000 / Wire->mbps;
+        n->wire_free = n->tx_end;
+        n->tx_started = TRUE;
+        n->wire_frames++;
+
+        if (rnd32(&WireRnd) % 1000000 < Wire->loss_ppm) {
+                n->wire_lost++;
+                return;
+        }
+        if (rnd32(&WireRnd) % 1000000 < Wire->reorder_ppm) {
+                n->wire_held++;
+                extra = Wire->reorder_ns;
+        }
+        sim_wire_put(dst, frame, len, n->tx_end + Wire->prop_ns + extra);
+}
+
+
+/* Tx progress and the frames that have arrived, before each SPI job */
+static void sim_service(node_t *n) {
+        uint64 now = k_cycle_get_64();
+        uint16 tsv = sim_reg16(n, ETXNDL) + 1;
+        wire_frame_t *f;
+        uint16 i;
+
+        if (n->tx_on && !n->tx_started) {
+                sim_tx_begin(n);
+        }
+        if (n->tx_on && n->tx_started && (now >= n->tx_end)) {
+                n->tx_on = FALSE;
+                n->tx_started = FALSE;
+                *sim_reg(n, SIM_KEY(ECON1)) &= ~ECON1_TXRTS;
+                *sim_reg(n, SIM_KEY(EIR)) |= EIR_TXIF;
+
+                /* transmit status vector, table 7-1 of datasheet */
+                memset(n->mem + tsv, 0, TSV_SZ);
+                n->mem[tsv] = LO_BYTE(n->tx_len);
+                n->mem[tsv+1] = HI_BYTE(n->tx_len);
+                n->mem[tsv+2] = TSV2_DONE;
+        }
+
+        /* in the order of arrival */
+        do {
+                f = NULL;
+                for (i = 0; i < SIM_WIRE_SLOTS; i++) {
+                        if (n->inq[i].used && (n->inq[i].arrive <= now) &&
+                                ((f == NULL) || (n->inq[i].arrive < f->arrive))) {
+                                f = &n->inq[i];
+                        }
+                }
+                if (f != NULL) {
+                        sim_rx_frame(n, f->data, f->len);
+                        f->used = FALSE;
+                }
+        } while (f != NULL);
+}
+
+
+/* copy, or checksum with ECON1.CSUMEN, from EDMAST to EDMAND (Rx ring wrap) */
+static void sim_dma(node_t *n) {
+        uint16 p = sim_reg16(n, EDMASTL), nd = sim_reg16(n, EDMANDL), dst = sim_reg16(n, EDMADSTL);
+        boolean csum = (*sim_reg(n, SIM_KEY(ECON1)) & ECON1_CSUMEN) ? TRUE : FALSE;
+        uint32 sum = 0;
+        uint16 i;
+
+        for (i = 0; i < SIM_MEM_SZ; i++) {
+                if (csum) {
+                        sum += (i & 1) ? n->mem[p] : (n->mem[p] << 8);
+                }
+                else {
+                        n->mem[dst] = n->mem[p];
+                        dst = (dst + 1) % SIM_MEM_SZ;
+                }
+                if (p == nd) {
+                        break;
+                }
+                p = sim_rx_next(n, p);
+        }
+        if (csum) {
+                while (sum >> 16) {
+                        sum = (sum & 0xFFFF) + (sum >> 16);
+                }
+                sim_reg16_set(n, EDMACSL, (uint16) ~sum);
+        }
+        *sim_reg(n, SIM_KEY(ECON1)) &= ~ECON1_DMAST;
+        *sim_reg(n, SIM_KEY(EIR)) |= EIR_DMAIF;
+}
+
+
+
+//////////////////////////////////////////////
+// register accesses
+static uint8 sim_reg_read(node_t *n, uint16 key) {
+        uint64 now = k_cycle_get_64();
+
+        if (key == SIM_KEY(ESTAT)) {
+                return *sim_reg(n, key) | ESTAT_CLKRDY;
+        }
+        if (key == SIM_KEY(EPKTCNT)) {
+                return n->pktcnt;
+        }
+        if (key == SIM_KEY(ERXWRPTL)) {
+                return LO_BYTE(n->rx_wr);
+        }
+        if (key == SIM_KEY(ERXWRPTH)) {
+                return HI_BYTE(n->rx_wr);
+        }
+        if (key == SIM_KEY(MISTAT)) {
+                return ((now < n->mii_busy) ? MISTAT_BUSY : 0) | (n->mii_scan ? MISTAT_SCAN : 0);
+        }
+        if (((key == SIM_KEY(MIRDL)) || (key == SIM_KEY(MIRDH))) && n->mii_scan) {
+                sim_mird_load(n);
+        }
+
+        return *sim_reg(n, key);
+}
+
+
+static void sim_reg_write(node_t *n, uint16 key, uint8 val) {
+        uint8 old = *sim_reg(n, key);
+        uint64 now = k_cycle_get_64();
+
+        *sim_reg(n, key) = val;
+        if (key == SIM_KEY(ECON1)) {
+                if ((val & ECON1_TXRTS) && !(old & ECON1_TXRTS)) {
+                        n->tx_on = TRUE;
+                        n->tx_started = FALSE;
+                        sim_tx_begin(n);
+                }
+                else if (n->tx_on) {
+                        *sim_reg(n, key) |= ECON1_TXRTS; // the MAC is not stopped by the model
+                }
+                if (val & ECON1_DMAST) {
+                        sim_dma(n);
+                }
+        }
+        else if (key == SIM_KEY(ECON2)) {
+                if ((val & ECON2_PKTDEC) && (n->pktcnt > 0)) {
+                        n->pktcnt--;
+                }
+                *sim_reg(n, key) &= ~ECON2_PKTDEC;
+        }
+        else if ((key == SIM_KEY(ERXSTL)) || (key == SIM_KEY(ERXSTH))) {
+                n->rx_wr = sim_reg16(n, ERXSTL);
+        }
+        else if (key == SIM_KEY(MICMD)) {
+                if (val & MICMD_MIIRD) {
+                        sim_mird_load(n);
+                        n->mii_busy = now + SIM_MII_NS;
+                }
+                if (val & MICMD_MIISCAN) {
+                        sim_mird_load(n);
+                        n->mii_scan = TRUE;
+                }
+                else if (n->mii_scan) {
+                        n->mii_scan = FALSE;
+                        n->mii_busy = now + SIM_MII_NS; // the scan in progress ends
+                }
+        }
+        else if (key == SIM_KEY(MIWRH)) {
+                sim_phy_write(n, *sim_reg(n, SIM_KEY(MIREGADR)), sim_reg16(n, MIWRL));
+                n->mii_busy = now + SIM_MII_NS;
+        }
+}
+
+
+/* one chip select: opcode + data */
+static void sim_spi_job(node_t *n, const uint8 *tx, uint8 *rx, uint16 len) {
+        uint16 key, ptr, i;
+        uint8 val;
+
+        sim_service(n);
+        if (len == 0) {
+                return;
+        }
+
+        key = SIM_KEY((*sim_reg(n, SIM_KEY(ECON1)) & 0x03) << 8 | (tx[0] & 0x1F));
+        if (tx[0] == SC_RST_OPCODE) {
+                sim_reset(n);
+        }
+        else if (tx[0] == RD_MEM_OPCODE) {
+                ptr = sim_reg16(n, ERDPTL);
+                for (i = 1; i < len; i++) {
+                        if (rx != NULL) {
+                                rx[i] = n->mem[ptr];
+                        }
+                        ptr = sim_rx_next(n, ptr); // wraps within the Rx ring only
+                }
+                sim_reg16_set(n, ERDPTL, ptr);
+        }
+        else if (tx[0] == WR_MEM_OPCODE) {
+                ptr = sim_reg16(n, EWRPTL);
+                for (i = 1; i < len; i++) {
+                        n->mem[ptr] = tx[i];
+                        ptr = (ptr + 1) % SIM_MEM_SZ;
+                }
+                sim_reg16_set(n, EWRPTL, ptr);
+        }
+        else if ((tx[0] & 0xE0) == RD_REG_OPCODE) {
+                val = sim_reg_read(n, key);
+                if ((rx != NULL) && (len >= 2)) {
+                        rx[1] = sim_is_mac_mii(key) ? 0xFF : val;
+                }
+                if ((rx != NULL) && (len >= 3) && sim_is_mac_mii(key)) {
+                        rx[2] = val;
+                }
+        }
+        else if (((tx[0] & 0xE0) == WR_REG_OPCODE) && (len >= 2)) {
+                sim_reg_write(n, key, tx[1]);
+        }
+        else if (((tx[0] & 0xE0) == BT_SET_OPCODE) && (len >= 2)) {
+                sim_reg_write(n, key, *sim_reg(n, key) | tx[1]);
+        }
+        else if (((tx[0] & 0xE0) == BT_CLR_OPCODE) && (len >= 2)) {
+                sim_reg_write(n, key, *sim_reg(n, key) & ~tx[1]);
+        }
+}
+
+
+
+//////////////////////////////////////////////
+// fake SPI, of the node that runs
+static struct {
+        const uint8 *tx;
+        uint8 *rx;
+        uint16 len;
+} SpiCh[SIM_SPI_CHANNELS];
+static uint8 SpiChCnt;
+
+
+Std_ReturnType Spi_SetupEB(Spi_ChannelType Channel, const Spi_DataBufferType* SrcDataBufferPtr,
+        Spi_DataBufferType* DesDataBufferPtr, Spi_NumberOfDataType Length) {
+        if (Channel >= SIM_SPI_CHANNELS) {
+                return E_NOT_OK;
+        }
+
+        SpiCh[Channel].tx = SrcDataBufferPtr;
+        SpiCh[Channel].rx = DesDataBufferPtr;
+        SpiCh[Channel].len = Length;
+        if (Channel >= SpiChCnt) {
+                SpiChCnt = Channel + 1;
+        }
+
+        return E_OK;
+}
+
+
+/* The basic sequence is the job of channel 0, the scatter / gather one is
+** channels 0 and 1 in one job, the chained ones a job per channel */
+Std_ReturnType Spi_SyncTransmit(Spi_SequenceEnumType Sequence) {
+        static uint8 sg[1 + MEM_POOL_BUF_LEN];
+        node_t *n = CurNode;
+        uint8 jobs = (Sequence == SEQ_ETHERNET_BASIC_TX_RX) ? 1 : SpiChCnt;
+        uint16 len;
+        uint8 i;
+
+        SpiChCnt = 0;
+        if ((n == NULL) || (jobs == 0)) {
+                return E_NOT_OK;
+        }
+
+        if (Sequence == SEQ_ETHERNET_WBM_SG) {
+                len = SpiCh[0].len + SpiCh[1].len;
+                if ((jobs != 2) || (len > sizeof(sg))) {
+                        return E_NOT_OK;
+                }
+                memcpy(sg, SpiCh[0].tx, SpiCh[0].len);
+                memcpy(sg + SpiCh[0].len, SpiCh[1].tx, SpiCh[1].len);
+                SpiCh[0].tx = sg;
+                SpiCh[0].rx = NULL;
+                SpiCh[0].len = len;
+                jobs = 1;
+        }
+
+        for (i = 0; i < jobs; i++) {
+                sim_spi_job(n, SpiCh[i].tx, SpiCh[i].rx, SpiCh[i].len);
+                len = SpiCh[i].len;
+                n->spi_bytes += len;
+                if ((k_cycle_get_64() >= RunStart) && (k_cycle_get_64() < RunEnd)) {
+                        n->spi_ns += SIM_SPI_JOB_NS + len * 8 * 1000000000ull / SIM_SPI_HZ;
+                }
+                host_clock_advance(SIM_SPI_JOB_NS + len * 8 * 1000000000ull / SIM_SPI_HZ);
+        }
+
+        return E_OK;
+}
+
+
+
+//////////////////////////////////////////////
+// application, through the public API of the driver copy of the node
+static uint16 app_len(node_t *n, pattern_t pat) {
+        switch (pat) {
+        case PAT_PING_PONG:
+                return SIM_PING_LEN;
+        case PAT_UNIDIR:
+                return SIM_MAX_PAYLOAD;
+        default:
+                return MixedSizes[rnd32(&n->app.rnd) % (sizeof(MixedSizes) / sizeof(MixedSizes[0]))];
+        }
+}
+
+
+static boolean app_send(node_t *n, payload_kind_t kind, uint32 seq, uint64 ts, uint16 len) {
+        Eth_BufIdxType idx;
+        uint16 blen = len, i;
+        uint8 *buf;
+
+        if (n->provide(0, 0, &idx, &buf, &blen) != BUFREQ_OK) {
+                n->app.tx_busy++;
+                return FALSE;
+        }
+
+        memcpy(buf + PL_SEQ, &seq, sizeof(seq));
+        memcpy(buf + PL_TS, &ts, sizeof(ts));
+        memcpy(buf + PL_LEN, &len, sizeof(len));
+        buf[PL_KIND] = (uint8) kind;
+        buf[PL_KIND+1] = 0;
+        for (i = PL_HDR_SZ; i < len; i++) {
+                buf[i] = (uint8)(seq * 7 + i);
+        }
+
+        if (n->transmit(0, idx, SIM_ETH_TYPE, FALSE, len, NodeCfg[peer(n)->id][0].ctrlcfg.mac_addres) != E_OK) {
+                n->app.tx_errors++;
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
+
+static void app_tx(node_t *n, pattern_t pat, boolean sending) {
+        app_t *a = &n->app;
+        uint64 now = k_cycle_get_64();
+        uint16 len;
+
+        if (pat == PAT_PING_PONG) {
+                if (a->pong_due && app_send(n, PL_PONG, a->pong_seq, a->pong_ts, SIM_PING_LEN)) {
+                        a->pong_due = FALSE;
+                }
+                if ((n->id == 0) && a->ping_out && (now - a->ping_sent > SIM_PING_TIMEOUT_NS)) {
+                        a->ping_out = FALSE;
+                        a->ping_lost++;
+                }
+                if ((n->id == 0) && sending && !a->ping_out && (a->pings < SIM_PINGS) &&
+                        app_send(n, PL_PING, a->pings, now, SIM_PING_LEN)) {
+                        a->ping_out = TRUE;
+                        a->ping_sent = now;
+                        a->pings++;
+                }
+                return;
+        }
+
+        if (!sending || ((pat == PAT_UNIDIR) && (n->id != 0))) {
+                return;
+        }
+        /* as fast as the Tx buffers come */
+        len = app_len(n, pat);
+        while ((a->tx_seq < SIM_MAX_SEQ) && app_send(n, PL_DATA, a->tx_seq, now, len)) {
+                a->tx_bytes += len;
+                a->tx_seq++;
+                len = app_len(n, pat);
+        }
+}
+
+
+static void app_sample(app_t *a, uint64 lat) {
+        if (a->lat_cnt < SIM_MAX_SAMPLES) {
+                a->lat_ns[a->lat_cnt++] = (uint32) lat;
+        }
+}
+
+
+static void app_rx_ind(uint8 CtrlIdx, Eth_FrameType FrameType, boolean IsBroadcast,
+        const uint8* PhysAddrPtr, const Eth_DataType* DataPtr, uint16 LenByte) {
+        node_t *n = CurNode;
+        app_t *a = &n->app;
+        uint64 now = k_cycle_get_64(), ts;
+        uint32 seq;
+        uint16 len, i;
+        boolean ok;
+
+        if ((FrameType != SIM_ETH_TYPE) || (LenByte < PL_HDR_SZ)) {
+                a->rx_bad++;
+                return;
+        }
+        memcpy(&seq, DataPtr + PL_SEQ, sizeof(seq));
+        memcpy(&ts, DataPtr + PL_TS, sizeof(ts));
+        memcpy(&len, DataPtr + PL_LEN, sizeof(len));
+
+        /* the frame must come as it was given, padded to the minimum */
+        ok = (memcmp(PhysAddrPtr, NodeCfg[peer(n)->id][0].ctrlcfg.mac_addres, 6) == 0) && !IsBroadcast &&
+                (LenByte == ((len < SIM_MIN_PAYLOAD) ? SIM_MIN_PAYLOAD : len)) && (seq < SIM_MAX_SEQ);
+        for (i = PL_HDR_SZ; ok && (i < len); i++) {
+                ok = (DataPtr[i] == (uint8)(seq * 7 + i));
+        }
+        if (!ok) {
+                a->rx_bad++;
+                return;
+        }
+
+        switch (DataPtr[PL_KIND]) {
+        case PL_PING:
+                a->pong_due = TRUE;
+                a->pong_seq = seq;
+                a->pong_ts = ts;
+                break;
+        case PL_PONG:
+                if (a->ping_out && (seq == a->pings - 1)) {
+                        app_sample(a, now - ts);
+                        a->ping_out = FALSE;
+                        a->pongs++;
+                }
+                break;
+        default:
+                if (a->rx_seen[seq / 8] & (1 << (seq % 8))) {
+                        a->rx_dups++;
+                        return;
+                }
+                a->rx_seen[seq / 8] |= 1 << (seq % 8);
+                if (seq + 1 < a->rx_next) {
+                        a->rx_reordered++;
+                }
+                else {
+                        a->rx_next = seq + 1;
+                }
+                a->rx_frames++;
+                if (now <= RunEnd) {
+                        a->rx_bytes_win += len;
+                }
+                app_sample(a, now - ts);
+                break;
+        }
+}
+
+
+
+//////////////////////////////////////////////
+// nodes
+static boolean node_load(node_t *n, const char *dir, int id) {
+        char path[512];
+
+        memset(n, 0, sizeof(*n));
+        n->id = id;
+        n->app.rnd = 0x9E3779B97F4A7C15ull * (id + 1);
+        snprintf(path, sizeof(path), "%s/eth_node%d.so", dir, id);
+        n->so = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (n->so == NULL) {
+                printf("FAIL: %s\n", dlerror());
+                return FALSE;
+        }
+
+        n->init = dlsym(n->so, "Eth_Init");
+        n->set_cbk = dlsym(n->so, "Eth_SetUpperLayerCbk");
+        n->provide = dlsym(n->so, "Eth_ProvideTxBuffer");
+        n->transmit = dlsym(n->so, "Eth_Transmit");
+        n->receive = dlsym(n->so, "Eth_Receive");
+        n->main_fn = dlsym(n->so, "Eth_MainFunction");
+        if (!n->init || !n->set_cbk || !n->provide || !n->transmit || !n->receive || !n->main_fn) {
+                printf("FAIL: %s: Eth API not found\n", path);
+                return FALSE;
+        }
+        memset(n->mem, 0xA5, sizeof(n->mem)); // power-on garbage
+
+        return TRUE;
+}
+
+
+static void node_enter(node_t *n) {
+        CurNode = n;
+        host_clock_set(n->now);
+}
+
+
+static void node_leave(node_t *n) {
+        n->now = k_cycle_get_64();
+        CurNode = NULL;
+}
+
+
+/* one turn of the owner loop of the node */
+static void node_step(node_t *n, pattern_t pat, boolean sending) {
+        Eth_RxStatusType st;
+        uint16 i = 0;
+
+        node_enter(n);
+        app_tx(n, pat, sending);
+        do {
+                n->receive(0, 0, &st);
+        } while ((st == ETH_RECEIVED_MORE_DATA_AVAILABLE) && (++i < SIM_RX_LOOP));
+        n->main_fn();
+        host_clock_advance(SIM_STEP_NS);
+        node_leave(n);
+}
+
+
+
+//////////////////////////////////////////////
+// report
+static int cmp_u32(const void *a, const void *b) {
+        uint32 x = *(const uint32 *) a, y = *(const uint32 *) b;
+
+        return (x > y) - (x < y);
+}
+
+
+static double pct_us(app_t *a, uint32 p) {
+        return a->lat_cnt ? a->lat_ns[(uint64)(a->lat_cnt - 1) * p / 100] / 1000.0 : 0;
+}
+
+
+static void report_lat(app_t *a) {
+        qsort(a->lat_ns, a->lat_cnt, sizeof(a->lat_ns[0]), cmp_u32);
+        printf("p50 %.1f, p90 %.1f, p99 %.1f, max %.1f us", pct_us(a, 50), pct_us(a, 90), pct_us(a, 99),
+                pct_us(a, 100));
+}
+
+
+/* the frames of tx to rx, every frame sent is received, lost on the wire or
+** dropped for the Rx ring full */
+static int report_dir(node_t *tx, node_t *rx, uint64 dur_ns) {
+        app_t *a = &rx->app;
+        double mbps = (double) a->rx_bytes_win * 8 * 1000 / dur_ns;
+        boolean clean = (Wire->loss_ppm == 0) && (Wire->reorder_ppm == 0);
+        int fail;
+
+        fail = (tx->app.tx_seq == 0) || a->rx_bad || a->rx_dups || tx->app.tx_errors ||
+                (tx->app.tx_seq != a->rx_frames + tx->wire_lost + rx->rx_overflows + rx->rx_filtered) ||
+                (mbps > Wire->mbps) || (clean && (tx->wire_lost || a->rx_reordered || rx->rx_overflows));
+
+        printf("  %s %d->%d: %u sent, %u received, %.2f Mbit/s goodput, %.0f pps, latency ", fail ? "FAIL" : "ok",
+                tx->id, rx->id, tx->app.tx_seq, a->rx_frames, mbps, (double) a->rx_frames * 1e9 / dur_ns);
+        report_lat(a);
+        printf("\n      wire: %u lost, %u held back; Rx: %u reordered, %u ring full, %u bad, %u dups; "
+                "PAUSE waits %u, SPI busy %.0f%%\n", tx->wire_lost, tx->wire_held, a->rx_reordered,
+                rx->rx_overflows, a->rx_bad, a->rx_dups, tx->pause_waits, 100.0 * tx->spi_ns / dur_ns);
+
+        return fail;
+}
+
+
+
+//////////////////////////////////////////////
+// a pattern on a wire, in a process of its own as the driver copies can't be reset
+static int run(const char *dir, const wire_cfg_t *w, pattern_t pat) {
+        node_t *n;
+        uint64 start, end;
+        uint32 held = 0, lost = 0;
+        int fail = 0, i;
+
+        Wire = w;
+        host_clock_sim = true;
+        for (i = 0; i < 2; i++) {
+                if (!node_load(&Nodes[i], dir, i)) {
+                        return 1;
+                }
+                node_enter(&Nodes[i]);
+                Nodes[i].init(NodeCfg[i]);
+                Nodes[i].set_cbk(app_rx_ind, NULL);
+                node_leave(&Nodes[i]);
+        }
+
+        /* both start once the slower one is up */
+        start = (Nodes[0].now > Nodes[1].now) ? Nodes[0].now : Nodes[1].now;
+        Nodes[0].now = Nodes[1].now = start;
+        end = start + ((pat == PAT_PING_PONG) ? 10 * SIM_RUN_NS : SIM_RUN_NS);
+        RunStart = start;
+        RunEnd = end;
+
+        /* the node that is behind goes first */
+        do {
+                n = (Nodes[0].now <= Nodes[1].now) ? &Nodes[0] : &Nodes[1];
+                node_step(n, pat, n->now < end);
+                if ((pat == PAT_PING_PONG) && (Nodes[0].app.pings == SIM_PINGS) && !Nodes[0].app.ping_out &&
+                        (end > n->now)) {
+                        end = RunEnd = n->now; // all pings done
+                }
+        } while (n->now < end + SIM_DRAIN_NS);
+
+        printf("%s: %s\n", PatName[pat], w->name);
+        if (pat == PAT_PING_PONG) {
+                app_t *a = &Nodes[0].app;
+                held = Nodes[0].wire_held + Nodes[1].wire_held;
+                lost = Nodes[0].wire_lost + Nodes[1].wire_lost;
+                fail = (a->pings != SIM_PINGS) || (a->pongs + a->ping_lost != a->pings) ||
+                        Nodes[0].app.rx_bad || Nodes[1].app.rx_bad ||
+                        ((w->loss_ppm == 0) && a->ping_lost) || (a->ping_lost > lost);
+                printf("  %s: %u pings, %u pongs, %u lost (%u frames lost, %u held back), %.0f exchanges/s, RTT ",
+                        fail ? "FAIL" : "ok", a->pings, a->pongs, a->ping_lost, lost, held,
+                        (double) a->pongs * 1e9 / (end - start));
+                report_lat(a);
+                printf("\n");
+        }
+        else {
+                fail += report_dir(&Nodes[0], &Nodes[1], end - start);
+                if (pat == PAT_BIDIR) {
+                        fail += report_dir(&Nodes[1], &Nodes[0], end - start);
+                }
+                /* the wire must have done its part */
+                held = Nodes[0].wire_held + Nodes[1].wire_held;
+                lost = Nodes[0].wire_lost + Nodes[1].wire_lost;
+                fail += (w->loss_ppm && !lost) || (w->reorder_ppm && (!held ||
+                        (Nodes[0].app.rx_reordered + Nodes[1].app.rx_reordered == 0)));
+        }
+        fail += (host_log_errors > 0);
+        printf("%s: %s, %s\n", fail ? "FAIL" : "PASS", PatName[pat], w->name);
+
+        return fail ? 1 : 0;
+}
+
+
+
+int main(int argc, char **argv) {
+        char *dir = dirname(strdup(argv[0]));
+        int status, fails = 0;
+        uint32 w, p;
+        pid_t pid;
+
+        for (w = 0; w < sizeof(Wires) / sizeof(Wires[0]); w++) {
+                for (p = 0; p < MAX_PAT; p++) {
+                        fflush(stdout);
+                        pid = fork();
+                        if (pid == 0) {
+                                exit(run(dir, &Wires[w], (pattern_t) p));
+                        }
+                        if ((pid < 0) || (waitpid(pid, &status, 0) != pid) ||
+                                !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+                                fails++;
+                        }
+                }
+        }
+
+        return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
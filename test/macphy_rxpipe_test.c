@@ -0,0 +1,167 @@
+/*
+ * Created on Mon Oct 19 2026 6:41:17 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <macphy.h>
+#include <macphy_rxpipe.h>
+
+
+// Host test of the two stage Rx pipe: the I/O stage and the delivery stage
+// run on threads pinned to different CPUs (the same one if there is only
+// one), as on a dual core part. The MACPHY is faked below, it has RXPIPE_FRAMES
+// frames of varying length, each with its number and a pattern from it. Its
+// pending count is kept as the enc28j60 and enc424j600 backends do: 0 until
+// the first read, then the frames left behind the last one read. The delivery
+// checks that the frames come in order, in full and unchanged.
+#define RXPIPE_FRAMES           (500000)
+#define RXPIPE_BUDGET           (8)
+
+static uint32 RxNext;           /* next frame of the fake MACPHY */
+static uint8 RxPending;         /* as RxPktsPending of the backends */
+static uint32 RxDelivered;
+static uint32 RxBad;
+
+
+
+static uint16 frame_len(uint32 n) {
+        return 60 + (n * 37) % (MACPHY_RX_PIPE_FRAME_LEN - 60 + 1);
+}
+
+
+
+// the fake MACPHY for macphy_rxpipe_io
+uint8 macphy_rx_pending(void) {
+        return RxPending;
+}
+
+
+
+uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+        uint16 len = frame_len(RxNext), i;
+
+        if (RxNext >= RXPIPE_FRAMES) {
+                RxPending = 0;
+                return 0;
+        }
+        RxPending = (RXPIPE_FRAMES-RxNext-1 > 255) ? 255 : (uint8)(RXPIPE_FRAMES-RxNext-1);
+        if (len > maxlen) {
+                return 0;
+        }
+        memcpy(pktptr, &RxNext, sizeof(RxNext));
+        for (i = sizeof(RxNext); i < len; i++) {
+                pktptr[i] = (uint8)(RxNext + i);
+        }
+        RxNext++;
+
+        return len;
+}
+
+
+
+static void rx_check(uint8 *frame, uint16 len) {
+        uint32 n;
+        uint16 i;
+
+        memcpy(&n, frame, sizeof(n));
+        if ((n != RxDelivered) || (len != frame_len(n))) {
+                RxBad++;
+        }
+        else {
+                for (i = sizeof(n); i < len; i++) {
+                        if (frame[i] != (uint8)(n + i)) {
+                                RxBad++;
+                                break;
+                        }
+                }
+        }
+        RxDelivered++;
+}
+
+
+
+static int pin_to_cpu(int cpu) {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+
+
+static void *io_stage(void *arg) {
+        pin_to_cpu(0);
+        while (RxNext < RXPIPE_FRAMES) {
+                if (macphy_rxpipe_io(RXPIPE_BUDGET) == 0) {
+                        sched_yield(); // all buffers wait for the delivery
+                }
+        }
+
+        return NULL;
+}
+
+
+
+static void *delivery_stage(void *arg) {
+        int cpu = *(int *) arg;
+
+        pin_to_cpu(cpu);
+        while (RxDelivered < RXPIPE_FRAMES) {
+                if (macphy_rxpipe_deliver(RXPIPE_BUDGET, rx_check) == 0) {
+                        sched_yield();
+                }
+        }
+
+        return NULL;
+}
+
+
+
+int main(void) {
+        macphy_rxpipe_stats_t stats;
+        pthread_t io, dlv;
+        int cpu, fail;
+
+        cpu = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? 1 : 0;
+        macphy_rxpipe_init();
+        pthread_create(&dlv, NULL, delivery_stage, &cpu);
+        pthread_create(&io, NULL, io_stage, NULL);
+        pthread_join(io, NULL);
+        pthread_join(dlv, NULL);
+
+        macphy_rxpipe_get_stats(&stats);
+        fail = (RxBad > 0) || (RxDelivered != RXPIPE_FRAMES) || (stats.frames != RXPIPE_FRAMES) ||
+                (stats.occupancy != 0);
+        printf("%s: rxpipe, I/O on cpu 0, delivery on cpu %d, %u frames, %u bad\n",
+                fail ? "FAIL" : "PASS", cpu, RxDelivered, RxBad);
+        printf("  handoff latency us min/avg/max %u/%u/%u, peak occupancy %u of %d, %u I/O stalls\n",
+                stats.lat_min_us, stats.lat_avg_us, stats.lat_max_us, stats.peak_occupancy,
+                MACPHY_RX_PIPE_BUFS, stats.io_stalls);
+
+        return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/*
+ * Created on Mon Oct 19 2026 Mon Oct 19 2026 9:14:52 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <macphy.h>
+#include <macphy_rxsteer.h>
+
+
+// Host test of the Rx flow steering. The fake MACPHY below keeps its pending
+// count as the enc28j60 and enc424j600 backends do: it starts at 0 and only a
+// read updates it, to the frames left behind the one read. Frames arrive in
+// bursts between the polls, every RXSTEER_BAD_EVERY-th one is discarded by the
+// read (as a frame too long for the buffer), and the rings are emptied after
+// each poll. Each frame carries its flow and its number within the flow, the
+// consumers check that every flow comes in order on the ring of its hash.
+#define RXSTEER_FRAMES          (200000)
+#define RXSTEER_FLOWS           (16)
+#define RXSTEER_BUDGET          (MACPHY_RX_STEER_DEPTH)
+#define RXSTEER_BAD_EVERY       (97)
+#define RXSTEER_MAX_POLLS       (RXSTEER_FRAMES * 4)
+
+static uint32 SimArrived;       /* frames the MAC wrote into the Rx buffer */
+static uint32 SimRead;          /* frames taken out of it by reads */
+static uint8 SimPending;        /* as RxPktsPending of the backends */
+static uint32 SimDiscarded;
+
+static uint32 FlowSent[RXSTEER_FLOWS];
+static uint32 FlowNext[RXSTEER_FLOWS];
+static uint32 RxGot[MACPHY_RX_STEER_RINGS];
+static uint32 RxBad;
+
+
+
+/* frame n belongs to flow n % RXSTEER_FLOWS, a UDP/IPv4 frame whose source
+** port is the flow, with its number within the flow in the payload */
+static uint16 frame_make(uint32 n, uint8 *buf) {
+        uint16 len = 64 + (n * 29) % 400, i;
+        uint8 flow = n % RXSTEER_FLOWS;
+        uint32 seq = FlowSent[flow]++;
+
+        for (i = 0; i < len; i++) {
+                buf[i] = (uint8)(n + i);
+        }
+        memcpy(buf, "\x02\x00\x00\x00\x00\x01\x02\x00\x00\x00\x00\x02\x08\x00", 14);
+        memset(buf + 14, 0, 20);
+        buf[14] = 0x45;
+        buf[14+9] = 17;
+        memcpy(buf + 14+12, "\xC0\xA8\x01\x02\xC0\xA8\x01\x03", 8);
+        buf[34] = 0x40;
+        buf[35] = flow;
+        buf[36] = 0x13;
+        buf[37] = 0x88;
+        buf[42] = flow;
+        memcpy(buf + 43, &seq, sizeof(seq));
+
+        return len;
+}
+
+
+
+// the fake MACPHY for macphy_rxsteer_poll
+uint8 macphy_rx_pending(void) {
+        return SimPending;
+}
+
+
+
+uint16 macphy_pkt_recv(uint8 *pktptr, uint16 maxlen) {
+        uint32 left = SimArrived - SimRead;
+        uint32 n = SimRead;
+        uint16 len;
+
+        if (left == 0) {
+                SimPending = 0;
+                return 0;
+        }
+        SimRead++;
+        SimPending = (left-1 > 255) ? 255 : (uint8)(left-1);
+
+        if ((n % RXSTEER_BAD_EVERY) == RXSTEER_BAD_EVERY-1) {
+                FlowSent[n % RXSTEER_FLOWS]++; // never seen by the consumers
+                FlowNext[n % RXSTEER_FLOWS]++;
+                SimDiscarded++;
+                return 0;
+        }
+        len = frame_make(n, pktptr);
+
+        return (len > maxlen) ? 0 : len;
+}
+
+
+
+static void rx_check(uint8 ring, const uint8 *frame, uint16 len) {
+        uint32 seq;
+        uint8 flow = frame[42];
+
+        memcpy(&seq, frame + 43, sizeof(seq));
+        if ((len < 47) || (flow >= RXSTEER_FLOWS) || (macphy_rxsteer_hash(frame, len) != ring) ||
+                (seq != FlowNext[flow])) {
+                RxBad++;
+                return;
+        }
+        FlowNext[flow]++;
+        RxGot[ring]++;
+}
+
+
+
+static void rings_drain(void) {
+        uint8 frame[MACPHY_RX_STEER_FRAME_LEN];
+        uint16 len;
+        uint8 r;
+
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                while ((len = macphy_rxsteer_get(r, frame, sizeof(frame))) > 0) {
+                        rx_check(r, frame, len);
+                }
+        }
+}
+
+
+
+int main(void) {
+        macphy_rxsteer_stats_t stats;
+        uint32 polls = 0, got = 0, dropped = 0;
+        uint16 first;
+        uint8 r;
+        int fail;
+
+        macphy_rxsteer_init();
+
+        /* one frame in the MACPHY, nothing was read yet: the count is 0 */
+        SimArrived = 1;
+        first = macphy_rxsteer_poll(RXSTEER_BUDGET);
+        rings_drain();
+
+        while ((SimRead < RXSTEER_FRAMES) && (polls < RXSTEER_MAX_POLLS)) {
+                SimArrived += (polls * 7) % 9; // bursts of 0 to 8
+                if (SimArrived > RXSTEER_FRAMES) {
+                        SimArrived = RXSTEER_FRAMES;
+                }
+                macphy_rxsteer_poll(RXSTEER_BUDGET);
+                rings_drain();
+                polls++;
+        }
+
+        macphy_rxsteer_get_stats(&stats);
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                got += RxGot[r];
+                dropped += stats.dropped[r];
+        }
+        fail = (first != 1) || (RxBad > 0) || (dropped > 0) || (got + SimDiscarded != RXSTEER_FRAMES);
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                fail |= (RxGot[r] == 0) || (stats.enqueued[r] != RxGot[r]) || (stats.depth[r] != 0);
+        }
+
+        printf("%s: rxsteer, first frame %s, %u frames over %u polls, %u discarded, %u bad, %u dropped\n",
+                fail ? "FAIL" : "PASS", (first == 1) ? "read" : "NOT read", got, polls, SimDiscarded,
+                RxBad, dropped);
+        printf("  per ring:");
+        for (r = 0; r < MACPHY_RX_STEER_RINGS; r++) {
+                printf(" %u (peak depth %u)", RxGot[r], stats.peak_depth[r]);
+        }
+        printf(", imbalance %u%%\n", stats.imbalance_pct);
+
+        return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+ * Created on Mon Oct 19 2026 6:20:05 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <macphy_mpool.h>
+#include <macphy_txq.h>
+#include <zephyr/sys/atomic.h>
+
+
+// Host test of the Tx submission ring (macphy_txq) and of the Tx pool claim,
+// with real threads: MPSC_PRODUCERS producers and one consumer check that no
+// frame is lost or duplicated and that the frames of each producer come out
+// in the order they were put. The pool claimers check that Tx never takes
+// the pools of the Rx reserve.
+#define MPSC_PRODUCERS          (4)
+#define MPSC_FRAMES             (200000) /* per producer */
+#define CLAIM_THREADS           (4)
+#define CLAIM_ROUNDS            (200000) /* per thread */
+
+// the ring only passes the pointers on, so they carry the producer and frame
+#define TAG(p, n)               ((spi_mpool_t *)(uintptr_t)((((uintptr_t)(p) + 1) << 32) | (n)))
+#define TAG_PRODUCER(m)         ((uint32)(((uintptr_t)(m) >> 32) - 1))
+#define TAG_FRAME(m)            ((uint32)((uintptr_t)(m) & 0xFFFFFFFF))
+
+static atomic_t ClaimHeld;
+static atomic_t ClaimViolations;
+static atomic_t ClaimTaken;
+
+
+
+static void *mpsc_producer(void *arg) {
+        uint32 p = (uint32)(uintptr_t) arg;
+        uint32 n;
+
+        for (n = 0; n < MPSC_FRAMES; n++) {
+                while (FALSE == macphy_txq_put(TAG(p, n))) {
+                        sched_yield(); // full, the consumer is behind
+                }
+        }
+
+        return NULL;
+}
+
+
+
+static int mpsc_test(void) {
+        pthread_t thr[MPSC_PRODUCERS];
+        uint32 next[MPSC_PRODUCERS] = { 0 };
+        uint64 total = 0, bad = 0;
+        spi_mpool_t *m;
+        uint32 p;
+
+        macphy_txq_init();
+        for (p = 0; p < MPSC_PRODUCERS; p++) {
+                pthread_create(&thr[p], NULL, mpsc_producer, (void *)(uintptr_t) p);
+        }
+
+        /* this thread is the owner context */
+        while (total < (uint64) MPSC_PRODUCERS * MPSC_FRAMES) {
+                m = macphy_txq_get();
+                if (m == NULL) {
+                        sched_yield();
+                        continue;
+                }
+                p = TAG_PRODUCER(m);
+                if ((p >= MPSC_PRODUCERS) || (TAG_FRAME(m) != next[p])) {
+                        if (bad++ < 10) {
+                                printf("  got frame %u of producer %u, expected %u\n",
+                                        TAG_FRAME(m), p, (p < MPSC_PRODUCERS) ? next[p] : 0);
+                        }
+                }
+                if (p < MPSC_PRODUCERS) {
+                        next[p] = TAG_FRAME(m) + 1;
+                }
+                total++;
+        }
+
+        for (p = 0; p < MPSC_PRODUCERS; p++) {
+                pthread_join(thr[p], NULL);
+        }
+        if (macphy_txq_get() != NULL) {
+                printf("  frames left in the ring after all were taken\n");
+                bad++;
+        }
+
+        printf("%s: mpsc, %d producers x %d frames, %llu out of order or lost\n",
+                bad ? "FAIL" : "PASS", MPSC_PRODUCERS, MPSC_FRAMES, (unsigned long long) bad);
+
+        return bad ? 1 : 0;
+}
+
+
+
+static void *pool_claimer(void *arg) {
+        spi_mpool_t *m;
+        uint32 r;
+
+        (void) arg;
+        for (r = 0; r < CLAIM_ROUNDS; r++) {
+                m = get_new_spi_mpool_tx();
+                if (m == NULL) {
+                        continue;
+                }
+                atomic_inc(&ClaimTaken);
+                if (atomic_inc(&ClaimHeld) + 1 > SPI_MEM_POOL_SIZE - SPI_MEM_POOL_RX_RESERVE) {
+                        atomic_inc(&ClaimViolations);
+                }
+                sched_yield();
+                atomic_dec(&ClaimHeld);
+                free_spi_mpool(m);
+        }
+
+        return NULL;
+}
+
+
+
+static int pool_claim_test(void) {
+        pthread_t thr[CLAIM_THREADS];
+        int t, fail;
+
+        for (t = 0; t < CLAIM_THREADS; t++) {
+                pthread_create(&thr[t], NULL, pool_claimer, NULL);
+        }
+        for (t = 0; t < CLAIM_THREADS; t++) {
+                pthread_join(thr[t], NULL);
+        }
+
+        fail = (atomic_get(&ClaimViolations) > 0) ||
+                (get_spi_mpool_tx_credit() != SPI_MEM_POOL_SIZE - SPI_MEM_POOL_RX_RESERVE);
+        printf("%s: tx pool claim, %ld taken, %ld times into the Rx reserve\n", fail ? "FAIL" : "PASS",
+                atomic_get(&ClaimTaken), atomic_get(&ClaimViolations));
+
+        return fail;
+}
+
+
+
+int main(void) {
+        int fails = 0;
+
+        fails += mpsc_test();
+        fails += pool_claim_test();
+
+        return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,14 @@
+/* Host build of the AUTOSAR ComStack types, for the tests under test/ only */
+#ifndef COMSTACK_TYPES_H
+#define COMSTACK_TYPES_H
+
+#include <Std_Types.h>
+
+typedef enum {
+        BUFREQ_OK,
+        BUFREQ_E_NOT_OK,
+        BUFREQ_E_BUSY,
+        BUFREQ_E_OVFL
+} BufReq_ReturnType;
+
+#endif
@@ -0,0 +1,28 @@
+/* Host build of the car_os platform types, for the tests under test/ only */
+#ifndef PLATFORM_TYPES_H
+#define PLATFORM_TYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t         uint8;
+typedef uint16_t        uint16;
+typedef uint32_t        uint32;
+typedef uint64_t        uint64;
+typedef int8_t          sint8;
+typedef int16_t         sint16;
+typedef int32_t         sint32;
+typedef int64_t         sint64;
+typedef uint8_t         boolean;
+
+typedef uint8_t         u8;
+typedef uint16_t        u16;
+typedef uint32_t        u32;
+
+#ifndef TRUE
+#define TRUE            (1u)
+#endif
+#ifndef FALSE
+#define FALSE           (0u)
+#endif
+
+#endif
@@ -0,0 +1,12 @@
+/* Host build of the Spi API, the tests provide the functions (fake SPI) */
+#ifndef SPI_H
+#define SPI_H
+
+#include <Std_Types.h>
+#include <Spi_cfg.h>
+
+Std_ReturnType Spi_SetupEB(Spi_ChannelType Channel, const Spi_DataBufferType* SrcDataBufferPtr,
+        Spi_DataBufferType* DesDataBufferPtr, Spi_NumberOfDataType Length);
+Std_ReturnType Spi_SyncTransmit(Spi_SequenceEnumType Sequence);
+
+#endif
@@ -0,0 +1,20 @@
+/* Host build of the Spi configuration, the sequences the Eth driver uses */
+#ifndef SPI_CFG_H
+#define SPI_CFG_H
+
+#include <Platform_Types.h>
+
+typedef enum {
+        SEQ_ETHERNET_BASIC_TX_RX,
+        SEQ_ETHERNET_TX_FRAME,
+        SEQ_ETHERNET_RX_HEAD,
+        SEQ_ETHERNET_RX_TAIL,
+        SEQ_ETHERNET_WBM_SG,
+        SPI_MAX_SEQUENCE
+} Spi_SequenceEnumType;
+
+typedef uint8 Spi_ChannelType;
+typedef uint8 Spi_DataBufferType;
+typedef uint16 Spi_NumberOfDataType;
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * Created on Mon Oct 19 2026 6:12:40 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+
+// Host shim of the Zephyr kernel calls of the driver, for the tests. A cycle
+// is a nanosecond. With host_clock_sim the clock only moves by the calls to
+// host_clock_advance (and the waits), so that the runs are repeatable.
+bool host_clock_sim;
+static uint64_t HostSimNs;
+static __thread char HostThreadTag;     /* its address is the thread id */
+static pthread_mutex_t HostIrqLock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+
+
+static uint64_t host_now_ns(void) {
+        struct timespec ts;
+
+        if (host_clock_sim) {
+                return __atomic_load_n(&HostSimNs, __ATOMIC_SEQ_CST);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+
+
+void host_clock_advance(uint64_t ns) {
+        __atomic_add_fetch(&HostSimNs, ns, __ATOMIC_SEQ_CST);
+}
+
+
+
+/* each node of the two node harness runs on its own time, the clock is set
+** to it when the node is switched to */
+void host_clock_set(uint64_t ns) {
+        __atomic_store_n(&HostSimNs, ns, __ATOMIC_SEQ_CST);
+}
+
+
+
+uint32_t k_cycle_get_32(void) {
+        return (uint32_t) host_now_ns();
+}
+
+
+
+uint64_t k_cycle_get_64(void) {
+        return host_now_ns();
+}
+
+
+
+int64_t k_uptime_get(void) {
+        return (int64_t)(host_now_ns() / 1000000);
+}
+
+
+
+uint32_t k_uptime_get_32(void) {
+        return (uint32_t) k_uptime_get();
+}
+
+
+
+uint32_t sys_clock_hw_cycles_per_sec(void) {
+        return 1000000000u;
+}
+
+
+
+void k_busy_wait(uint32_t usec_to_wait) {
+        uint64_t end;
+
+        if (host_clock_sim) {
+                host_clock_advance((uint64_t) usec_to_wait * 1000);
+                return;
+        }
+        end = host_now_ns() + (uint64_t) usec_to_wait * 1000;
+        while (host_now_ns() < end) {
+                ;
+        }
+}
+
+
+
+int32_t k_sleep(k_timeout_t timeout) {
+        struct timespec ts;
+
+        if (timeout.us <= 0) {
+                return 0;
+        }
+        if (host_clock_sim) {
+                host_clock_advance((uint64_t) timeout.us * 1000);
+                return 0;
+        }
+        ts.tv_sec = timeout.us / 1000000;
+        ts.tv_nsec = (timeout.us % 1000000) * 1000;
+        nanosleep(&ts, NULL);
+
+        return 0;
+}
+
+
+
+k_tid_t k_current_get(void) {
+        return (k_tid_t) &HostThreadTag;
+}
+
+
+
+int k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit) {
+        pthread_mutex_init(&sem->lock, NULL);
+        pthread_cond_init(&sem->cond, NULL);
+        sem->count = initial_count;
+        sem->limit = limit;
+
+        return 0;
+}
+
+
+
+/* With the simulated clock nobody else can give the semaphore while the
+** caller waits, hence the timeout passes at once */
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout) {
+        struct timespec ts;
+        int rc = 0;
+
+        pthread_mutex_lock(&sem->lock);
+        if ((sem->count == 0) && (timeout.us != 0) && host_clock_sim) {
+                if (timeout.us > 0) {
+                        host_clock_advance((uint64_t) timeout.us * 1000);
+                }
+        }
+        else if ((sem->count == 0) && (timeout.us != 0)) {
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_sec += timeout.us / 1000000;
+                ts.tv_nsec += (timeout.us % 1000000) * 1000;
+                if (ts.tv_nsec >= 1000000000) {
+                        ts.tv_sec++;
+                        ts.tv_nsec -= 1000000000;
+                }
+                while ((sem->count == 0) && (rc == 0)) {
+                        rc = (timeout.us < 0) ? pthread_cond_wait(&sem->cond, &sem->lock) :
+                                pthread_cond_timedwait(&sem->cond, &sem->lock, &ts);
+                }
+        }
+        if (sem->count > 0) {
+                sem->count--;
+                rc = 0;
+        }
+        else {
+                rc = -EAGAIN;
+        }
+        pthread_mutex_unlock(&sem->lock);
+
+        return rc;
+}
+
+
+
+void k_sem_give(struct k_sem *sem) {
+        pthread_mutex_lock(&sem->lock);
+        if (sem->count < sem->limit) {
+                sem->count++;
+        }
+        pthread_cond_signal(&sem->cond);
+        pthread_mutex_unlock(&sem->lock);
+}
+
+
+
+unsigned int irq_lock(void) {
+        pthread_mutex_lock(&HostIrqLock);
+        return 0;
+}
+
+
+
+void irq_unlock(unsigned int key) {
+        (void) key;
+        pthread_mutex_unlock(&HostIrqLock);
+}
+
+
+
+/* the errors and warnings go to stderr, the rest only with HOST_LOG_ALL set;
+** the fault injection tests count them in host_log_errors instead */
+bool host_log_quiet;
+uint32_t host_log_errors;
+
+void host_log(const char *lvl, const char *fmt, ...) {
+        va_list ap;
+
+        if (lvl != NULL) {
+                __atomic_add_fetch(&host_log_errors, 1, __ATOMIC_RELAXED);
+        }
+        if ((lvl == NULL) ? (getenv("HOST_LOG_ALL") == NULL) : (host_log_quiet && !getenv("HOST_LOG_ALL"))) {
+                return;
+        }
+        va_start(ap, fmt);
+        fprintf(stderr, "[%s] ", lvl ? lvl : "I");
+        vfprintf(stderr, fmt, ap);
+        fprintf(stderr, "\n");
+        va_end(ap);
+}
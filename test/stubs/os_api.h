@@ -0,0 +1,7 @@
+/* Host build of the car_os API, for the tests under test/ only */
+#ifndef OS_API_H
+#define OS_API_H
+
+#include <zephyr/kernel.h>
+
+#endif
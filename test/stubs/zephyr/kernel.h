@@ -0,0 +1,58 @@
+/* Host build of the Zephyr kernel API used by the driver, see host_os.c.
+** A cycle is a nanosecond of the host clock, or of the simulated clock once
+** host_clock_sim is set (see the two node harness). */
+#ifndef ZEPHYR_KERNEL_H
+#define ZEPHYR_KERNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <zephyr/sys/atomic.h>
+
+typedef struct {
+        int64_t us;     /* < 0 waits forever */
+} k_timeout_t;
+
+#define K_USEC(t)       ((k_timeout_t){ .us = (t) })
+#define K_MSEC(t)       ((k_timeout_t){ .us = (int64_t)(t) * 1000 })
+#define K_NO_WAIT       ((k_timeout_t){ .us = 0 })
+#define K_FOREVER       ((k_timeout_t){ .us = -1 })
+
+struct k_sem {
+        pthread_mutex_t lock;
+        pthread_cond_t  cond;
+        unsigned int    count;
+        unsigned int    limit;
+};
+
+struct k_thread;
+typedef struct k_thread *k_tid_t;
+
+uint32_t k_cycle_get_32(void);
+uint64_t k_cycle_get_64(void);
+uint32_t k_uptime_get_32(void);
+int64_t  k_uptime_get(void);
+uint32_t sys_clock_hw_cycles_per_sec(void);
+void     k_busy_wait(uint32_t usec_to_wait);
+int32_t  k_sleep(k_timeout_t timeout);
+k_tid_t  k_current_get(void);
+
+int  k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit);
+int  k_sem_take(struct k_sem *sem, k_timeout_t timeout);
+void k_sem_give(struct k_sem *sem);
+
+unsigned int irq_lock(void);
+void irq_unlock(unsigned int key);
+
+static inline uint64_t k_cyc_to_ns_floor64(uint64_t t) { return t; }
+static inline uint64_t k_cyc_to_ns_ceil64(uint64_t t) { return t; }
+static inline uint32_t k_cyc_to_us_floor32(uint64_t t) { return (uint32_t)(t / 1000); }
+static inline uint32_t k_cyc_to_us_ceil32(uint64_t t) { return (uint32_t)((t + 999) / 1000); }
+static inline uint32_t k_us_to_cyc_ceil32(uint64_t t) { return (uint32_t)(t * 1000); }
+
+// host_os.c only, for the tests
+extern bool host_clock_sim;
+void host_clock_advance(uint64_t ns);
+void host_clock_set(uint64_t ns);
+
+#endif
@@ -0,0 +1,25 @@
+/* Host build of the Zephyr logging, errors and warnings go to stderr */
+#ifndef ZEPHYR_LOG_H
+#define ZEPHYR_LOG_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERR   1
+#define LOG_LEVEL_WRN   2
+#define LOG_LEVEL_INF   3
+#define LOG_LEVEL_DBG   4
+
+#define LOG_MODULE_REGISTER(name, level) extern int host_log_##name
+#define LOG_ERR(...)    host_log("E", __VA_ARGS__)
+#define LOG_WRN(...)    host_log("W", __VA_ARGS__)
+#define LOG_INF(...)    host_log(NULL, __VA_ARGS__)
+#define LOG_DBG(...)    host_log(NULL, __VA_ARGS__)
+
+void host_log(const char *lvl, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+extern bool host_log_quiet;
+extern uint32_t host_log_errors;
+
+#endif
@@ -0,0 +1,53 @@
+/* Host build of the Zephyr atomics on the GCC builtins, sequentially consistent as in Zephyr */
+#ifndef ZEPHYR_ATOMIC_H
+#define ZEPHYR_ATOMIC_H
+
+#include <stdbool.h>
+
+typedef long atomic_t;
+typedef atomic_t atomic_val_t;
+
+#define ATOMIC_INIT(i)  (i)
+
+static inline bool atomic_cas(atomic_t *target, atomic_val_t old_value, atomic_val_t new_value) {
+        return __atomic_compare_exchange_n(target, &old_value, new_value, false,
+                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_get(const atomic_t *target) {
+        return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value) {
+        return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_add(atomic_t *target, atomic_val_t value) {
+        return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t *target) {
+        return atomic_add(target, 1);
+}
+
+static inline atomic_val_t atomic_dec(atomic_t *target) {
+        return atomic_add(target, -1);
+}
+
+static inline bool atomic_test_and_set_bit(atomic_t *target, int bit) {
+        return (__atomic_fetch_or(target, 1L << bit, __ATOMIC_SEQ_CST) & (1L << bit)) != 0;
+}
+
+static inline void atomic_clear_bit(atomic_t *target, int bit) {
+        __atomic_fetch_and(target, ~(1L << bit), __ATOMIC_SEQ_CST);
+}
+
+static inline void atomic_set_bit(atomic_t *target, int bit) {
+        __atomic_fetch_or(target, 1L << bit, __ATOMIC_SEQ_CST);
+}
+
+static inline bool atomic_test_bit(const atomic_t *target, int bit) {
+        return (atomic_get(target) & (1L << bit)) != 0;
+}
+
+#endif
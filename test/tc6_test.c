@@ -0,0 +1,540 @@
+/*
+ * Created on Mon Oct 19 2026 7:32:50 PM
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 Aananth C N
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial
+ * portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+ * TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Spi.h>
+#include <tc6.h>
+#include <zephyr/logging/log.h>
+
+
+// Chunk level simulator of an OPEN Alliance TC6 MACPHY behind the fake SPI,
+// for host tests of the tc6 backend. It answers the control transactions from
+// a small register file and the data transfers chunk by chunk: Tx chunks are
+// put together into frames (the "wire"), Rx frames are cut into chunks, two
+// of them share a chunk where the second one fits. Bad headers (HDRB) and
+// failed SPI transfers can be injected. As a MACPHY would, it drops the Tx
+// frame in progress on a bad header and ignores the chunks up to the next
+// start of frame.
+#define SIM_TX_BUF_CHUNKS       (24)    /* MACPHY Tx buffer */
+#define SIM_TX_DRAIN_CHUNKS     (3)     /* chunks sent on the wire per transfer */
+#define SIM_FRAMES              (300)
+#define SIM_MAX_FRAME           (1514)
+#define SIM_MAX_LOOPS           (200000)
+#define SIM_HDR_SZ              (4)
+
+typedef struct {
+        /* registers */
+        uint32  config0;
+        uint32  status0;
+        uint32  mac_regs[0x24];
+        boolean prote;
+        uint16  cps;            /* chunk payload size, from CONFIG0 */
+
+        /* Tx */
+        uint8   tx_frame[SIM_MAX_FRAME + 64];
+        uint16  tx_len;
+        boolean tx_in_frame;
+        uint16  tx_free;        /* free chunks in the Tx buffer */
+        uint32  tx_dropped;     /* frames in progress dropped due to a bad header */
+        uint32  tx_overflows;
+
+        /* Rx, frames are made from their number, see frame_make */
+        uint32  rx_next;        /* frame being cut into chunks */
+        uint32  rx_last;        /* frames up to this one are queued */
+        uint16  rx_ofs;
+
+        /* faults */
+        uint32  chunks;
+        uint32  xfers;
+        uint32  hdrb_1_in;      /* chunks, at random */
+        uint32  fail_1_in;      /* data transfers, at random */
+        uint32  rand;
+        uint32  hdrb_injected;
+        uint32  fails_injected;
+} tc6_sim_t;
+
+static tc6_sim_t Sim;
+static const uint8 *SpiTxBuf;
+static uint8 *SpiRxBuf;
+static uint16 SpiLen;
+
+// what came out of the MACPHY on the wire and out of the driver
+static uint8 TxSeen[SIM_FRAMES];
+static uint8 RxSeen[SIM_FRAMES];
+static uint32 TxOrderErrors, TxBadFrames, RxOrderErrors, RxBadFrames;
+static uint32 TxNextExpected, RxNextExpected;
+
+
+
+/* deterministic, so that a failing run can be repeated */
+static uint32 sim_rand(void) {
+        Sim.rand = Sim.rand * 1103515245u + 12345u;
+        return Sim.rand >> 8;
+}
+
+
+static inline void put_be32(uint8 *p, uint32 v) {
+        p[0] = (uint8)(v >> 24);
+        p[1] = (uint8)(v >> 16);
+        p[2] = (uint8)(v >> 8);
+        p[3] = (uint8)(v);
+}
+
+
+static inline uint32 get_be32(const uint8 *p) {
+        return ((uint32)p[0] << 24) | ((uint32)p[1] << 16) | ((uint32)p[2] << 8) | p[3];
+}
+
+
+static inline uint32 odd_bits(uint32 v) {
+        return (uint32) __builtin_parity(v);
+}
+
+
+static inline uint32 add_parity(uint32 v) {
+        v &= ~1u;
+        return v | (odd_bits(v) ? 0 : 1);
+}
+
+
+
+// frame n: its number, then a pattern from it, 60 to SIM_MAX_FRAME bytes long
+static uint16 frame_len(uint32 n) {
+        return 60 + (n * 97) % (SIM_MAX_FRAME - 60 + 1);
+}
+
+
+static void frame_make(uint32 n, uint8 *buf) {
+        uint16 i;
+
+        memcpy(buf, &n, sizeof(n));
+        for (i = sizeof(n); i < frame_len(n); i++) {
+                buf[i] = (uint8)(n * 7 + i);
+        }
+}
+
+
+/* checks a frame against frame_make, returns its number or -1 */
+static long frame_check(const uint8 *buf, uint16 len) {
+        static uint8 ref[SIM_MAX_FRAME];
+        uint32 n;
+
+        if (len < sizeof(n)) {
+                return -1;
+        }
+        memcpy(&n, buf, sizeof(n));
+        if ((n >= SIM_FRAMES) || (len != frame_len(n))) {
+                return -1;
+        }
+        frame_make(n, ref);
+
+        return memcmp(buf, ref, len) ? -1 : (long) n;
+}
+
+
+
+//////////////////////////////////////////////
+// MACPHY model
+static uint16 sim_rx_chunks_avail(void) {
+        uint32 n, chunks = 0;
+        uint16 left;
+
+        for (n = Sim.rx_next; (n < Sim.rx_last) && (chunks < 31); n++) {
+                left = frame_len(n) + 4 - ((n == Sim.rx_next) ? Sim.rx_ofs : 0); // + FCS
+                chunks += (left + Sim.cps - 1) / Sim.cps;
+        }
+
+        return (chunks > 31) ? 31 : chunks;
+}
+
+
+static void sim_reset(void) {
+        Sim.config0 = 0;
+        Sim.status0 = STATUS0_RESETC;
+        Sim.prote = FALSE;
+        Sim.tx_in_frame = FALSE;
+        Sim.tx_free = SIM_TX_BUF_CHUNKS;
+        Sim.rx_ofs = 0;
+}
+
+
+static uint32 sim_reg_read(uint8 mms, uint16 addr) {
+        if (mms == TC6_MMS_MAC) {
+                return (addr < 0x24) ? Sim.mac_regs[addr] : 0;
+        }
+
+        switch (addr) {
+        case TC6_IDVER:         return 0x00000011;
+        case TC6_PHYID:         return 0x0007C1B3;
+        case TC6_CONFIG0:       return Sim.config0;
+        case TC6_STATUS0:       return Sim.status0;
+        case TC6_BUFSTS:        return ((uint32) Sim.tx_free << BUFSTS_TXC_SHIFT) | sim_rx_chunks_avail();
+        case TC6_PHY_BASIC_STATUS: return PHY_BASIC_STATUS_LINK;
+        default:                return 0;
+        }
+}
+
+
+static void sim_reg_write(uint8 mms, uint16 addr, uint32 val) {
+        static const uint16 cps[8] = { 0, 0, 0, 8, 16, 32, 64, 0 };
+
+        if (mms == TC6_MMS_MAC) {
+                if (addr < 0x24) {
+                        Sim.mac_regs[addr] = val;
+                }
+                return;
+        }
+
+        switch (addr) {
+        case TC6_RESET:
+                if (val & RESET_SWRESET) {
+                        sim_reset();
+                }
+                break;
+        case TC6_CONFIG0:
+                Sim.config0 = val;
+                Sim.cps = cps[val & 0x7];
+                break;
+        case TC6_STATUS0:
+                Sim.status0 &= ~val;
+                break;
+        default:
+                break;
+        }
+}
+
+
+/* header, cnt words (with complements if protected), and the echo lags a word */
+static void sim_ctrl_xfer(const uint8 *in, uint8 *out, uint16 len) {
+        uint32 hdr = get_be32(in), word;
+        uint16 wsz = Sim.prote ? 8 : 4, cnt, addr, k;
+        uint8 mms;
+
+        memset(out, 0, len);
+        if (odd_bits(hdr) == 0) {
+                put_be32(out + 4, hdr | TC6_CTL_HDRB);
+                return;
+        }
+        put_be32(out + 4, hdr);
+
+        mms = (hdr >> TC6_CTL_MMS_SHIFT) & 0x0F;
+        addr = (hdr >> TC6_CTL_ADDR_SHIFT) & 0xFFFF;
+        cnt = ((hdr >> TC6_CTL_LEN_SHIFT) & 0x7F) + 1;
+        for (k = 0; (k < cnt) && (8 + k * wsz + wsz <= len); k++) {
+                if (hdr & TC6_CTL_WNR) {
+                        word = get_be32(in + 4 + k * wsz);
+                        if (Sim.prote && (get_be32(in + 8 + k * wsz) != ~word)) {
+                                Sim.status0 |= STATUS0_CDPE;
+                                continue;
+                        }
+                        sim_reg_write(mms, addr + k, word);
+                }
+                else {
+                        word = sim_reg_read(mms, addr + k);
+                        put_be32(out + 8 + k * wsz, word);
+                        if (Sim.prote) {
+                                put_be32(out + 12 + k * wsz, ~word);
+                        }
+                }
+        }
+
+        /* the protection applies from the next transaction on */
+        Sim.prote = (Sim.config0 & CONFIG0_PROTE) ? TRUE : FALSE;
+}
+
+
+static void sim_wire_out(const uint8 *frame, uint16 len) {
+        long n = frame_check(frame, len);
+
+        if (n < 0) {
+                TxBadFrames++;
+                return;
+        }
+        if ((uint32) n != TxNextExpected) {
+                TxOrderErrors++;
+        }
+        TxNextExpected = n + 1;
+        TxSeen[n]++;
+}
+
+
+static void sim_tx_chunk(uint32 hdr, const uint8 *payload) {
+        uint16 swo = ((hdr >> TC6_HDR_SWO_SHIFT) & 0x0F) * 4;
+        uint16 end = (hdr & TC6_HDR_EV) ? ((hdr >> TC6_HDR_EBO_SHIFT) & 0x3F) + 1 : Sim.cps;
+
+        if (Sim.tx_free == 0) {
+                Sim.status0 |= STATUS0_TXBOE;
+                Sim.tx_overflows++;
+                return;
+        }
+        Sim.tx_free--;
+
+        if (hdr & TC6_HDR_SV) {
+                if (Sim.tx_in_frame) {
+                        Sim.tx_dropped++;
+                }
+                Sim.tx_in_frame = TRUE;
+                Sim.tx_len = 0;
+        }
+        else {
+                swo = 0;
+        }
+        if ((Sim.tx_in_frame == FALSE) || (end < swo) ||
+                (Sim.tx_len + end - swo > sizeof(Sim.tx_frame))) {
+                Sim.tx_in_frame = FALSE;
+                return;
+        }
+
+        memcpy(Sim.tx_frame + Sim.tx_len, payload + swo, end - swo);
+        Sim.tx_len += end - swo;
+        if (hdr & TC6_HDR_EV) {
+                sim_wire_out(Sim.tx_frame, Sim.tx_len);
+                Sim.tx_in_frame = FALSE;
+        }
+}
+
+
+/* next Rx chunk, a frame that ends early leaves room for the next one from
+** the next word on. Returns the footer bits of the Rx data. */
+static uint32 sim_rx_chunk(uint8 *payload) {
+        static uint8 frame[SIM_MAX_FRAME + 4];
+        uint32 ftr = 0;
+        uint16 total, n, swo = 0;
+
+        while ((Sim.rx_next < Sim.rx_last) && (swo < Sim.cps)) {
+                frame_make(Sim.rx_next, frame);
+                total = frame_len(Sim.rx_next) + 4; // FCS, any value
+                if (Sim.rx_ofs == 0) {
+                        if ((ftr & TC6_FTR_SV) || (total - Sim.rx_ofs <= Sim.cps - swo)) {
+                                if (swo > 0) {
+                                        break; // one start per chunk, and a start + end only at 0
+                                }
+                        }
+                        ftr |= TC6_FTR_SV | ((uint32)(swo / 4) << TC6_FTR_SWO_SHIFT);
+                }
+                n = total - Sim.rx_ofs;
+                if (n > Sim.cps - swo) {
+                        n = Sim.cps - swo;
+                }
+                memcpy(payload + swo, frame + Sim.rx_ofs, n);
+                Sim.rx_ofs += n;
+                ftr |= TC6_FTR_DV;
+                if (Sim.rx_ofs < total) {
+                        break;
+                }
+                ftr |= TC6_FTR_EV | ((uint32)(swo + n - 1) << TC6_FTR_EBO_SHIFT);
+                Sim.rx_next++;
+                Sim.rx_ofs = 0;
+                swo = ((swo + n + 3) / 4) * 4;
+        }
+
+        return ftr;
+}
+
+
+static void sim_data_chunk(const uint8 *in, uint8 *out) {
+        uint32 hdr = get_be32(in), ftr = 0;
+
+        Sim.chunks++;
+        memset(out, 0, Sim.cps);
+        if ((odd_bits(hdr) == 0) || ((hdr & TC6_HDR_DNC) == 0) ||
+                (Sim.hdrb_1_in && ((sim_rand() % Sim.hdrb_1_in) == 0))) {
+                Sim.hdrb_injected++;
+                ftr |= TC6_FTR_HDRB;
+                if (Sim.tx_in_frame) {
+                        Sim.tx_in_frame = FALSE;
+                        Sim.tx_dropped++;
+                }
+        }
+        else {
+                if (hdr & TC6_HDR_DV) {
+                        sim_tx_chunk(hdr, in + SIM_HDR_SZ);
+                }
+                if ((hdr & TC6_HDR_NORX) == 0) {
+                        ftr |= sim_rx_chunk(out);
+                }
+        }
+
+        ftr |= (Sim.config0 & CONFIG0_SYNC) ? TC6_FTR_SYNC : 0;
+        ftr |= (Sim.status0 & ~STATUS0_RESETC) ? TC6_FTR_EXST : 0;
+        ftr |= (uint32) sim_rx_chunks_avail() << TC6_FTR_RCA_SHIFT;
+        ftr |= (uint32)((Sim.tx_free > 31) ? 31 : Sim.tx_free) << TC6_FTR_TXC_SHIFT;
+        put_be32(out + Sim.cps, add_parity(ftr));
+}
+
+
+
+//////////////////////////////////////////////
+// fake SPI, the tc6 backend uses the channel 0 only
+Std_ReturnType Spi_SetupEB(Spi_ChannelType Channel, const Spi_DataBufferType* SrcDataBufferPtr,
+        Spi_DataBufferType* DesDataBufferPtr, Spi_NumberOfDataType Length) {
+        if (Channel != 0) {
+                return E_NOT_OK;
+        }
+        SpiTxBuf = SrcDataBufferPtr;
+        SpiRxBuf = DesDataBufferPtr;
+        SpiLen = Length;
+
+        return E_OK;
+}
+
+
+Std_ReturnType Spi_SyncTransmit(Spi_SequenceEnumType Sequence) {
+        uint16 csz, i;
+
+        if ((SpiTxBuf[0] & 0x80) == 0) {
+                sim_ctrl_xfer(SpiTxBuf, SpiRxBuf, SpiLen);
+                return E_OK;
+        }
+
+        Sim.xfers++;
+        if (Sim.fail_1_in && ((sim_rand() % Sim.fail_1_in) == 0)) {
+                Sim.fails_injected++;
+                return E_NOT_OK; // e.g., a bus error before the chip select
+        }
+        csz = SIM_HDR_SZ + Sim.cps;
+        for (i = 0; i + csz <= SpiLen; i += csz) {
+                sim_data_chunk(SpiTxBuf + i, SpiRxBuf + i);
+        }
+
+        /* the MACPHY sends from its Tx buffer meanwhile */
+        Sim.tx_free += SIM_TX_DRAIN_CHUNKS;
+        if (Sim.tx_free > SIM_TX_BUF_CHUNKS) {
+                Sim.tx_free = SIM_TX_BUF_CHUNKS;
+        }
+
+        return E_OK;
+}
+
+
+
+//////////////////////////////////////////////
+// test scenarios
+static Eth_ConfigType TestCfg = {
+        .ctrlcfg = {
+                .spi_device = ETH_DEV_TC6,
+                .mac_addres = { 0x00, 0x7D, 0xFA, 0xBA, 0xBA, 0x06 }
+        },
+        .spi_cfg = {
+                .pay_ld_size = 64,
+                .spisequence = SEQ_ETHERNET_BASIC_TX_RX
+        }
+};
+
+
+
+static int run(const char *name, uint8 cps, uint32 hdrb_1_in, uint32 fail_1_in) {
+        static uint8 buf[SIM_MAX_FRAME];
+        Eth_ConfigSpiCfgType *spi_cfg = (Eth_ConfigSpiCfgType *) &TestCfg.spi_cfg;
+        uint32 tx_next = 0, loops, n, tx_once = 0, rx_once = 0, dups = 0;
+        tc6_stats_t stats0, stats;
+        uint16 len;
+        long id;
+        int fail;
+
+        memset(&Sim, 0, sizeof(Sim));
+        memset(TxSeen, 0, sizeof(TxSeen));
+        memset(RxSeen, 0, sizeof(RxSeen));
+        TxOrderErrors = TxBadFrames = RxOrderErrors = RxBadFrames = 0;
+        TxNextExpected = RxNextExpected = 0;
+        sim_reset();
+        tc6_get_stats(&stats0);
+        host_log_errors = 0;
+        *(uint8 *) &spi_cfg->pay_ld_size = cps;
+
+        if (FALSE == tc6_init(&TestCfg)) {
+                printf("FAIL: %s, tc6_init\n", name);
+                return 1;
+        }
+        Sim.hdrb_1_in = hdrb_1_in;
+        Sim.fail_1_in = fail_1_in;
+        Sim.rand = 1;
+        host_log_quiet = (hdrb_1_in || fail_1_in) ? TRUE : FALSE;
+        Sim.rx_last = SIM_FRAMES;
+
+        for (loops = 0; loops < SIM_MAX_LOOPS; loops++) {
+                if ((tx_next < SIM_FRAMES) && (tc6_tx_credit() > 0)) {
+                        frame_make(tx_next, buf);
+                        if (tc6_pkt_send(buf, frame_len(tx_next))) {
+                                tx_next++;
+                        }
+                }
+                tc6_periodic_fn();
+                while ((len = tc6_pkt_recv(buf, sizeof(buf))) > 0) {
+                        id = frame_check(buf, len);
+                        if (id < 0) {
+                                RxBadFrames++;
+                                continue;
+                        }
+                        if ((uint32) id != RxNextExpected) {
+                                RxOrderErrors++;
+                        }
+                        RxNextExpected = id + 1;
+                        RxSeen[id]++;
+                }
+                if ((tx_next == SIM_FRAMES) && (Sim.rx_next == SIM_FRAMES) && (tc6_rx_pending() == 0) &&
+                        (tc6_tx_credit() == SPI_MEM_POOL_SIZE - SPI_MEM_POOL_RX_RESERVE)) {
+                        break;
+                }
+        }
+
+        for (n = 0; n < SIM_FRAMES; n++) {
+                tx_once += (TxSeen[n] == 1) ? 1 : 0;
+                rx_once += (RxSeen[n] == 1) ? 1 : 0;
+                dups += ((TxSeen[n] > 1) ? 1 : 0) + ((RxSeen[n] > 1) ? 1 : 0);
+        }
+        tc6_get_stats(&stats);
+        host_log_quiet = FALSE;
+
+        /* every Tx frame exactly once, in order unless some were sent again;
+        an Rx frame in the middle of a failed transfer is lost */
+        fail = (loops == SIM_MAX_LOOPS) || (tx_once != SIM_FRAMES) || dups || TxBadFrames ||
+                RxBadFrames || Sim.tx_overflows || (!hdrb_1_in && !fail_1_in && TxOrderErrors) ||
+                RxOrderErrors > Sim.fails_injected ||
+                (SIM_FRAMES - rx_once > Sim.fails_injected);
+        printf("%s: %s, %u loops, Tx %u/%d once, Rx %u/%d once, %u dups, %u bad\n",
+                fail ? "FAIL" : "PASS", name, loops, tx_once, SIM_FRAMES, rx_once, SIM_FRAMES,
+                dups, TxBadFrames + RxBadFrames);
+        printf("  %u xfers, %u chunks, %u HDRB and %u SPI failures injected, %u errors logged\n",
+                stats.xfers - stats0.xfers, stats.chunks - stats0.chunks, Sim.hdrb_injected,
+                Sim.fails_injected, host_log_errors);
+        printf("  %u Tx frames sent again, %u dropped by the MACPHY, %u Rx frames dropped\n",
+                stats.tx_retries - stats0.tx_retries, Sim.tx_dropped, stats.rx_dropped - stats0.rx_dropped);
+
+        return fail;
+}
+
+
+
+int main(void) {
+        int fails = 0;
+
+        fails += run("clean, 64 byte chunks", 64, 0, 0);
+        fails += run("clean, 32 byte chunks", 32, 0, 0);
+        fails += run("HDRB on 1 in 40 chunks", 64, 40, 0);
+        fails += run("SPI failure on 1 in 10 transfers", 64, 0, 10);
+        fails += run("HDRB on 1 in 60 chunks, SPI failure on 1 in 20 transfers", 32, 60, 20);
+
+        return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+#
+# Created on Mon Oct 19 2026 4:58:37 PM
+#
+# The MIT License (MIT)
+# Copyright (c) 2026 Aananth C N
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+# and associated documentation files (the "Software"), to deal in the Software without restriction,
+# including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial
+# portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+# TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# Converts a raw dump of MacPhyPcap (see src/macphy/macphy_pcap.h) into a
+# pcap file for Wireshark.
+#
+# Dump the buffer from the target, e.g. with gdb:
+#   dump binary value pcap.bin MacPhyPcap
+# and convert:
+#   macphy_pcapdump.py pcap.bin -o capture.pcap
+#
+import argparse
+import struct
+import sys
+
+
+PCAP_MAGIC = 0x5043504D
+HDR_FMT = "<IIIHH"
+REC_FMT = "<IHBB"
+DIR_RX = 0x01
+DIR_TX = 0x02
+
+
+def load_records(path, hz_override):
+    with open(path, "rb") as f:
+        blob = f.read()
+
+    magic, head, hz, snaplen, size = struct.unpack_from(HDR_FMT, blob, 0)
+    if magic != PCAP_MAGIC:
+        sys.exit("%s: bad magic 0x%08x, not a MacPhyPcap dump" % (path, magic))
+    if hz_override:
+        hz = hz_override
+    if hz == 0:
+        sys.exit("cycle frequency unknown, pass --hz")
+
+    stride = struct.calcsize(REC_FMT) + snaplen
+    base = struct.calcsize(HDR_FMT)
+    if len(blob) < base + size * stride:
+        sys.exit("%s: truncated dump, expected %d bytes" % (path, base + size * stride))
+
+    # oldest record first
+    cnt = min(head, size)
+    records = []
+    cyc = 0
+    last = None
+    for i in range(head - cnt, head):
+        ofs = base + (i % size) * stride
+        cycles, orig_len, caplen, direction = struct.unpack_from(REC_FMT, blob, ofs)
+        data = blob[ofs + struct.calcsize(REC_FMT):ofs + struct.calcsize(REC_FMT) + caplen]
+        if last is not None:
+            cyc += (cycles - last) & 0xFFFFFFFF
+        last = cycles
+        records.append((cyc * 1000000 // hz, direction, orig_len, data))
+
+    return snaplen, records
+
+
+def write_pcap(path, snaplen, records):
+    with open(path, "wb") as f:
+        f.write(struct.pack("<IHHiIII", 0xA1B2C3D4, 2, 4, 0, 0, snaplen, 1))
+        for t_us, _, orig_len, data in records:
+            f.write(struct.pack("<IIII", t_us // 1000000, t_us % 1000000, len(data), orig_len))
+            f.write(data)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="MacPhyPcap dump to pcap")
+    ap.add_argument("dump", help="raw binary dump of MacPhyPcap")
+    ap.add_argument("-o", "--output", default="capture.pcap", help="pcap output")
+    ap.add_argument("--dir", choices=["rx", "tx", "all"], default="all", help="frames to keep")
+    ap.add_argument("--hz", type=int, default=0, help="override the cycle counter frequency")
+    args = ap.parse_args()
+
+    snaplen, records = load_records(args.dump, args.hz)
+    if args.dir != "all":
+        keep = DIR_RX if args.dir == "rx" else DIR_TX
+        records = [r for r in records if r[1] == keep]
+    write_pcap(args.output, snaplen, records)
+
+    rx = sum(1 for r in records if r[1] == DIR_RX)
+    print("%s: %d frames (%d rx, %d tx)" % (args.output, len(records), rx, len(records) - rx))
+
+
+if __name__ == "__main__":
+    main()
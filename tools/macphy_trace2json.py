@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+#
+# Created on Mon Oct 19 2026 9:40:02 AM
+#
+# The MIT License (MIT)
+# Copyright (c) 2026 Aananth C N
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+# and associated documentation files (the "Software"), to deal in the Software without restriction,
+# including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+# subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial
+# portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+# TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+# TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# Converts a raw dump of MacPhyTrace (see src/macphy/macphy_trace.h) into a
+# Chrome / Perfetto trace JSON and prints per-stage latency histograms.
+#
+# Dump the buffer from the target, e.g. with gdb:
+#   dump binary value trace.bin MacPhyTrace
+# and convert:
+#   macphy_trace2json.py trace.bin -o trace.json
+#
+import argparse
+import json
+import struct
+import sys
+
+
+TRACE_MAGIC = 0x4352544D
+HDR_FMT = "<IIII"
+
+# must be in sync with macphy_trc_evt_t
+EVENTS = [
+    "TX_BUF_PROVIDED",
+    "TX_SPI_WR_START",
+    "TX_SPI_WR_DONE",
+    "TX_TXRTS_SET",
+    "TX_COMPLETE",
+    "RX_PKTCNT_SEEN",
+    "RX_HDR_READ",
+    "RX_PAYLOAD_READ",
+    "RX_DELIVERED",
+]
+TX_EVENTS = EVENTS[0:5]
+RX_EVENTS = EVENTS[5:9]
+
+
+def load_records(path, hz_override):
+    with open(path, "rb") as f:
+        blob = f.read()
+
+    magic, head, hz, _ = struct.unpack_from(HDR_FMT, blob, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit("%s: bad magic 0x%08x, not a MacPhyTrace dump" % (path, magic))
+    if hz_override:
+        hz = hz_override
+    if hz == 0:
+        sys.exit("cycle frequency unknown, pass --hz")
+
+    body = blob[struct.calcsize(HDR_FMT):]
+    size = len(body) // 8
+    words = struct.unpack_from("<%dQ" % size, body, 0)
+
+    # oldest record first
+    if head > size:
+        order = [(head + i) % size for i in range(size)]
+    else:
+        order = range(head)
+
+    records = []
+    wraps = 0
+    last = None
+    for i in order:
+        w = words[i]
+        cyc = w & 0xFFFFFFFF
+        seq = (w >> 32) & 0xFFFFFF
+        evt = (w >> 56) & 0xFF
+        if evt >= len(EVENTS):
+            continue
+        if last is not None and cyc < last:
+            wraps += 1
+        last = cyc
+        t_us = ((wraps << 32) + cyc) * 1e6 / hz
+        records.append((t_us, EVENTS[evt], seq))
+
+    return records
+
+
+def build_frames(records):
+    frames = {}
+    for t_us, evt, seq in records:
+        key = ("TX" if evt in TX_EVENTS else "RX", seq)
+        frames.setdefault(key, {})[evt] = t_us
+    return frames
+
+
+def chrome_trace(frames):
+    events = []
+    for (direction, seq), stamps in sorted(frames.items(), key=lambda x: min(x[1].values())):
+        stages = TX_EVENTS if direction == "TX" else RX_EVENTS
+        for a, b in zip(stages, stages[1:]):
+            if a in stamps and b in stamps:
+                events.append({
+                    "name": "%s->%s" % (a, b),
+                    "cat": direction,
+                    "ph": "X",
+                    "ts": stamps[a],
+                    "dur": stamps[b] - stamps[a],
+                    "pid": 1,
+                    "tid": 1 if direction == "TX" else 2,
+                    "args": {"seq": seq},
+                })
+    meta = [
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 1, "args": {"name": "Tx"}},
+        {"name": "thread_name", "ph": "M", "pid": 1, "tid": 2, "args": {"name": "Rx"}},
+    ]
+    return {"traceEvents": meta + events, "displayTimeUnit": "ns"}
+
+
+def histograms(frames, out):
+    for direction, stages in (("TX", TX_EVENTS), ("RX", RX_EVENTS)):
+        for a, b in zip(stages, stages[1:]):
+            lat = [s[b] - s[a] for (d, _), s in frames.items()
+                   if d == direction and a in s and b in s]
+            if not lat:
+                continue
+            lat.sort()
+            out.write("%s -> %s: n=%d min=%.1f p50=%.1f p99=%.1f max=%.1f us\n" % (
+                a, b, len(lat), lat[0], lat[len(lat) // 2],
+                lat[min(len(lat) - 1, (len(lat) * 99) // 100)], lat[-1]))
+            # power of 2 buckets in micro seconds
+            buckets = {}
+            for v in lat:
+                ub = 1
+                while ub < v:
+                    ub <<= 1
+                buckets[ub] = buckets.get(ub, 0) + 1
+            for ub in sorted(buckets):
+                bar = "#" * max(1, (buckets[ub] * 50) // len(lat))
+                out.write("  <= %6d us %6d %s\n" % (ub, buckets[ub], bar))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="MacPhyTrace dump to Chrome trace JSON")
+    ap.add_argument("dump", help="raw binary dump of MacPhyTrace")
+    ap.add_argument("-o", "--output", default="trace.json", help="Chrome trace JSON output")
+    ap.add_argument("--hz", type=int, default=0, help="override the cycle counter frequency")
+    args = ap.parse_args()
+
+    frames = build_frames(load_records(args.dump, args.hz))
+    with open(args.output, "w") as f:
+        json.dump(chrome_trace(frames), f)
+    histograms(frames, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()